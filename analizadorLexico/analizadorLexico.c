@@ -11,1207 +11,1350 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
+#include <stdint.h>
 #include "analizadorLexico.h"
 #include "../definiciones.h"
 #include "../sistemaEntrada/sistemaEntrada.h"
 #include "../gestionErrores/gestionErrores.h"
+#include "../perfilado/perfilado.h"
+#include "../unicode/unicode.h"
 
-FILE* ficheroEntrada;
+static _Thread_local FILE* ficheroEntrada; // Fichero que se pasa al sistema de entrada (propio de cada hilo)
 
-//Autómata para el componente léxico ID
-void automataID(char *charActual, token *tokenProcesado);
+// Estado de líneas que se usa si no se ha seleccionado otro, y estado seleccionado (propios de cada hilo)
+static _Thread_local estadoLineas estadoPorDefecto;
+static _Thread_local estadoLineas *estadoActual = NULL;
 
-//Autómata para el componente léxico NÚMEROS ENTEROS
-int automataInts(char *charActual, token *tokenProcesado);
+/**
+ * Estados de los autómatas. Cada estado es una etiqueta y cada transición salta directamente a la
+ * del estado siguiente, así que cada transición tiene su propio salto y su propia predicción en vez
+ * de pasar todas por el salto indirecto del switch. Con DESPACHO_SWITCH (make DESPACHO=switch) los
+ * mismos autómatas se compilan como el bucle con switch, para poder comparar las dos versiones.
+ * En ambos casos un estado que no salta ni devuelve nada sigue en el estado escrito a continuación
+ */
+#ifdef DESPACHO_SWITCH
+#define AUTOMATA(estadoInicial) int estado = (estadoInicial); despacharEstado: switch(estado)
+#define ESTADO(n) case n
+#define IR_A(n) if(1){ estado = (n); goto despacharEstado; } else (void) 0
+#else
+#define AUTOMATA(estadoInicial) goto estado_##estadoInicial;
+#define ESTADO(n) estado_##n
+#define IR_A(n) goto estado_##n
+#endif
 
-//Autómata para el componente léxico NÚMEROS FLOTANTES e IMAGINARIOS
-int automataFloats(char *charActual, token *tokenProcesado);
+// Clases de los caracteres ASCII, sin ctype: sus funciones dependen del locale y cada llamada pasa por
+// la tabla del locale actual. EOF no pertenece a ninguna clase
+#define ES_DIGITO(c) ((unsigned) (c) - '0' < 10u)
+#define ES_LETRA(c) ((unsigned) ((c) | 0x20) - 'a' < 26u)
+#define ES_INICIO_ID(c) (ES_LETRA(c) || (c) == '_')
+#define ES_PARTE_ID(c) (ES_INICIO_ID(c) || ES_DIGITO(c))
 
-//Autómata para el componente léxico OPERADORES
-int automataOp(char *charActual, token *tokenProcesado);
+// Valor que devuelve el autómata de identificadores si el caracter no empieza un identificador
+#define NO_ES_ID -1
 
-//Autómata para el componente léxico DELIMITADORES
-int automataDel(char *charActual, token *tokenProcesado);
+// Prefijos de los strings, se combinan (rb, br, rf y fr) y no distinguen mayúsculas
+#define PREFIJO_UNICODE 1
+#define PREFIJO_CRUDO 2
+#define PREFIJO_BYTES 4
+#define PREFIJO_FORMATEADO 8
 
-//Autómata para el componente léxico STRING
-int automataString(char *charActual, token *tokenProcesado);
+// Formas de un signo de puntuación a partir de su primer caracter (la columna forma de SIGNOS_PUNTUACION):
+// el caracter solo ('*'), seguido de '=' ('*='), doble ('**'), doble seguido de '=' ('**=') y triple ('...')
+#define SIGNO_SOLO 0
+#define SIGNO_CON_IGUAL 1
+#define SIGNO_DOBLE 2
+#define SIGNO_DOBLE_CON_IGUAL 3
+#define SIGNO_TRIPLE 4
 
-//Salta los comentarios del tipo """ o '''
-int automataComentariosComillas(char *charActual);
+// Signos de puntuación que empiezan por un mismo caracter
+typedef struct signoPuntuacion {
+    int componente[5]; // Componente léxico de cada forma, 0 si no existe
+} signoPuntuacion;
 
-//----------------------------------------------------------
-//-------------------- FUNCION PRINCIPAL--------------------
-//----------------------------------------------------------
+// Tabla de los signos de puntuación indexada por su primer caracter, generada a partir de definiciones.h
+#define FILA_SIGNO(nombre, codigo, lexema, clase, primero, forma) [primero].componente[forma] = nombre,
 
-// Función que devuelve el siguiente token (es decir el siguiente componente léxico)
-int seguinte_comp_lexico(token *tokenProcesado, hashTable *tabla, FILE *fichero){
+static const signoPuntuacion signosPuntuacion[128] = {
+    SIGNOS_PUNTUACION(FILA_SIGNO)
+};
 
-    if(fichero == NULL){
-        printf("Error: No se ha abierto el fichero de entrada\n");
-        exit(EXIT_FAILURE);
-    }
+#undef FILA_SIGNO
 
-    ficheroEntrada = fichero;
+// Lexema y clase (OP o DEL) de cada signo, indexados por su código menos PRIMER_SIGNO
+#define LEXEMA_SIGNO(nombre, codigo, lexema, clase, primero, forma) [codigo - PRIMER_SIGNO] = lexema,
+#define CLASE_SIGNO(nombre, codigo, lexema, clase, primero, forma) [codigo - PRIMER_SIGNO] = clase,
 
-    //-------------------- COMENTARIOS Y ESPACIOS --------------------
+static const char *lexemasSignos[ULTIMO_SIGNO - PRIMER_SIGNO + 1] = { SIGNOS_PUNTUACION(LEXEMA_SIGNO) };
+static const int clasesSignos[ULTIMO_SIGNO - PRIMER_SIGNO + 1] = { SIGNOS_PUNTUACION(CLASE_SIGNO) };
 
-    // Para este analizador léxico, saltamos los comentarios y los espacio en blanco, tabuladores y saltos de línea.
-    // Los comentruiois los identificamos con el caracter '#'.
-    // Los comentarios de tipo """ o ''' los saltamos con el automataComentariosComillas
+#undef LEXEMA_SIGNO
+#undef CLASE_SIGNO
 
-    char charActual = devolverDelantero();
-    moverInicioLexemaADelantero();
+// Palabras reservadas con su longitud, para reconocerlas sin copiar el lexema
+#define FILA_PALABRA(nombre, codigo, lexema) { lexema, sizeof(lexema) - 1, nombre },
 
-    int contadorCharSaltados = 0;
+static const struct { const char *lexema; size_t longitud; int componente; } palabrasReservadas[] = {
+    PALABRAS_RESERVADAS(FILA_PALABRA)
+};
 
-    while(charActual == ' ' || charActual == '\n' || charActual == '\t' || charActual == '#'
-          || charActual == '\"' || charActual == '\'' || charActual == '\0'){
+#undef FILA_PALABRA
 
-        if(charActual == '#'){
-            while(charActual != '\n'){
-                charActual = siguienteCaracter(ficheroEntrada);
-            }
-            moverInicioLexemaADelantero();
-            continue;
-        }
-        //Saltamos los comentarios del tipo """ o '''
-        else if(charActual == '\"' || charActual == '\''){
-            if(automataComentariosComillas(&charActual)){
-                moverInicioLexemaADelantero();
-                continue;
-            }
-            else break;
-        }
-        charActual = siguienteCaracter(ficheroEntrada);
-        contadorCharSaltados++;
-    }
+// Lexema de cada palabra reservada indexado por su código menos PRIMERA_PALABRA_RESERVADA (NULL en los huecos)
+#define LEXEMA_PALABRA(nombre, codigo, lexema) [codigo - PRIMERA_PALABRA_RESERVADA] = lexema,
 
-    //Avanzamos el inicio hasta acabar el comentario
-    if(contadorCharSaltados>0){
-        moverInicioLexemaADelantero();
-    }
+static const char *lexemasPalabras[ULTIMA_PALABRA_RESERVADA - PRIMERA_PALABRA_RESERVADA + 1] = { PALABRAS_RESERVADAS(LEXEMA_PALABRA) };
 
-    //-------------------- 1: CADENAS ALFANUMÉRICAS --------------------
+#undef LEXEMA_PALABRA
 
-    // Si el caracter es una letra, podria ser el inicio de una cadema alfanumérica
+//Autómata para el componente léxico ID, devuelve el prefijo si lo leído es el prefijo de un string.
+//La variante Ascii es la de las entradas que solo tienen caracteres ASCII (ver automataID.h)
+int automataIDAscii(int *charActual, token *tokenProcesado);
+int automataIDUtf8(int *charActual, token *tokenProcesado);
 
-    if(isalpha(charActual) || charActual == '_'){
-        automataID(&charActual, tokenProcesado);
+//Lee un caracter UTF-8 que empieza o continúa un identificador, devuelve sus bytes o 0 si no lo es
+int leerCaracterID(int *charActual, int inicio);
 
-        tokenProcesado->componente = buscarElemento(tokenProcesado->lexema, *tabla);
+//Prefijo de string formado por los caracteres leídos, 0 si no es un prefijo válido
+int prefijoString(char primero, char segundo, int longitud);
 
-        if(tokenProcesado->componente == 0){
-            tokenProcesado->componente = ID;
-            insertarElemento(*tokenProcesado, tabla);
-        }
+//Autómata para los componentes léxicos NÚMEROS ENTEROS, FLOTANTES e IMAGINARIOS
+int automataNumeros(int *charActual, token *tokenProcesado);
 
-        charActual = siguienteCaracter(ficheroEntrada);
+//Devuelve el literal numérico reconocido junto con su valor
+int aceptarNumero(int *charActual, token *tokenProcesado, int componente, int enteroGrande, int64_t entero, int malFormado);
+int saltarGuion(int *charActual, int base);
 
-        return 1;
-    }
+//Valor de un dígito hexadecimal, -1 si no lo es
+int valorDigito(int c);
 
-    //-------------------- 2: NÚMEROS --------------------
+//Autómata para los componentes léxicos OPERADORES y DELIMITADORES
+int automataPuntuacion(int *charActual, token *tokenProcesado);
 
-    // Si el caracter es un número, podria ser el inicio de un número
-    if(isdigit(charActual) || charActual == '.'){
+//Devuelve la forma indicada de un signo de puntuación
+int aceptarSigno(const signoPuntuacion *signo, int forma, token *tokenProcesado);
 
-        if (charActual != '.'){
-            if(automataInts(&charActual, tokenProcesado)){
-                
-                tokenProcesado->componente = NUM_INT;
-            
-                charActual = siguienteCaracter(ficheroEntrada);
+//Devuelve un componente de la estructura de líneas (NEWLINE, INDENT o DEDENT)
+int componenteEstructura(int componente, token *tokenProcesado);
 
-                return 1; 
-            }
-        }
-
-        if(automataFloats(&charActual, tokenProcesado)){
-
-            tokenProcesado->componente = NUM_FLOAT;
-            
-            charActual = siguienteCaracter(ficheroEntrada);
+//Salta el fin de línea del delantero ("\n", "\r\n" o "\r") y devuelve el caracter siguiente
+int saltarFinLinea(int c);
 
-            return 1; 
-        }
-    }
+//Componente de la palabra reservada que ocupa los caracteres indicados, 0 si no es una palabra reservada
+int palabraReservada(const char *inicio, size_t longitud);
 
-    //-------------------- 3: OPERADORES --------------------
+//Autómata para el componente léxico STRING
+int automataString(int *charActual, token *tokenProcesado, int prefijo);
 
-    // Si el caracter es un operador, podria ser el inicio de un operador
-    if(charActual == '+' || charActual == '-' || charActual == '*' || charActual == '/' ||
-       charActual == '%' || charActual == '=' || charActual == '!' || charActual == '<' ||
-       charActual == '>' || charActual == '&' || charActual == '|' || charActual == '^' ||
-       charActual == '~' || charActual == '@' || charActual == ':'){
+//Avanza desde la comilla de apertura de un string hasta la de cierre
+int escanearString(int *charActual, int prefijo);
 
-        if(automataOp(&charActual, tokenProcesado)){
+//Salta una barra invertida y el caracter (o la secuencia \N{...}) que escapa
+int saltarEscape(char comilla, int formateado, int crudo);
 
-            tokenProcesado->componente = buscarElemento(tokenProcesado->lexema, *tabla);
+//Salta un campo de sustitución de un f-string que no se separa
+int saltarCampoFstring(int *charActual, char comilla, int triple);
 
-            if(tokenProcesado->componente == 0){
-                tokenProcesado->componente = OP;
-            }
+//Devuelve FSTRING_INICIO y abre el marco de un f-string que se separa
+int iniciarFstring(int *charActual, token *tokenProcesado, estadoLineas *lineas, int prefijo);
 
-            charActual = siguienteCaracter(ficheroEntrada);
+//Autómata para el texto de un f-string separado y las especificaciones de formato de sus campos
+int automataTextoFstring(token *tokenProcesado, estadoLineas *lineas);
 
-            return 1;
-        }
-    }
+//Devuelve el texto de un f-string leído hasta el caracter anterior al delantero
+int textoFstring(token *tokenProcesado);
 
-    //-------------------- 4: DELIMITADORES --------------------
+//Devuelve FSTRING_FIN (el delantero está en la última comilla de cierre) y cierra el marco del f-string
+int finFstring(token *tokenProcesado, estadoLineas *lineas);
 
-    // Si el caracter es un delimitador, podria ser el inicio de un delimitador
-    if(charActual == '(' || charActual == ')' || charActual == '{' || charActual == '}' || charActual == '['
-       || charActual == ']' || charActual == ',' || charActual == ';' || charActual == '.' || charActual == ':'
-       || charActual == '=' || charActual == '+' || charActual == '-' || charActual == '*' || charActual == '/'
-       || charActual == '%' || charActual == '@' || charActual == '&' || charActual == '|' || charActual == '^'
-       || charActual == '>' || charActual == '<'){
+//Cierra los campos abiertos del f-string actual
+void cerrarCamposFstring(estadoLineas *lineas);
 
-        if(automataDel(&charActual, tokenProcesado)){
+//Indica si el caracter puede empezar un componente léxico (o es un separador)
+int puntoSincronizacion(int c);
 
-            tokenProcesado->componente = buscarElemento(tokenProcesado->lexema, *tabla);
+//----------------------------------------------------------
+//-------------------- FUNCION PRINCIPAL--------------------
+//----------------------------------------------------------
 
-            if(tokenProcesado->componente == 0){
-                tokenProcesado->componente = DEL;
-            }
+// Función que devuelve el siguiente token (es decir el siguiente componente léxico)
+int seguinte_comp_lexico(token *tokenProcesado, hashTable *tabla, FILE *fichero){
 
-            charActual = siguienteCaracter(ficheroEntrada);
+    // El fichero solo se pasa al sistema de entrada, que es quien conoce la fuente de los caracteres
+    // (puede ser NULL si se analiza una zona de memoria)
+    ficheroEntrada = fichero;
 
-            return 1;
-        }
+    estadoLineas *lineas = estadoActual != NULL ? estadoActual : &estadoPorDefecto;
 
+    tokenProcesado->valor = (valorNumerico) { .tipo = VALOR_NINGUNO };
+    tokenProcesado->simbolo = -1;
 
+    // Los DEDENT de una bajada de varios niveles se devuelven de uno en uno
+    if(lineas->dedentsPendientes > 0){
+        lineas->dedentsPendientes--;
+        posicionDelantero(&tokenProcesado->posicion);
+        return componenteEstructura(DEDENT, tokenProcesado);
     }
 
-    //-------------------- 5: STRINGS -------------------- 
+    // Dentro de un f-string separado, su texto y las especificaciones de formato de sus campos no
+    // siguen las reglas del resto del código. Las expresiones de los campos se analizan normalmente
+    if(lineas->numMarcos > 0){
+        marcoFstring *marco = &lineas->marcos[lineas->numMarcos - 1];
 
-    // Si el caracter es una comilla doble, podria ser el inicio de un string   
-    if(charActual == '\"' || charActual == '\''){
-        if(automataString(&charActual, tokenProcesado)){
+        if(marco->tipo == MARCO_TEXTO || marco->especificacion){
+            int resultado = PERFIL_AUTOMATA(AUTOMATA_FSTRING, automataTextoFstring(tokenProcesado, lineas));
 
-            tokenProcesado->componente = STRING;
-            
-            charActual = siguienteCaracter(ficheroEntrada);
-
-            return 1;
+            if(resultado != -1) return resultado;
         }
     }
 
-    //-------------------- 6: FIN DE FICHERO o CARACTER DESCONOCIDO --------------------
-
-    if(charActual == '\000' || charActual == EOF){
-        tokenProcesado->componente = EOF;
-
-        printf("Fin de fichero\n");
-        return 0;
-
-    } else {
-        caracterNoReconocido(charActual);
-        return 0;
-    }
-
-}
+    //-------------------- COMENTARIOS, ESPACIOS Y SALTOS DE LÍNEA --------------------
 
+    // Para este analizador léxico, saltamos los comentarios y los espacio en blanco y tabuladores.
+    // Los comentruiois los identificamos con el caracter '#'.
+    // Los strings de tipo """ o ''' (docstrings incluidos) son componentes STRING, como en Python.
+    // Un salto de línea acaba la línea lógica (NEWLINE) si tiene componentes y no hay paréntesis abiertos.
+    // Como en Python, "\r\n" y un '\r' solo también son saltos de línea
 
+    int charActual = devolverDelantero();
+    moverInicioLexemaADelantero();
 
+    int columna = 0; // Sangría de la línea, solo cuenta si la línea lógica aún no tiene componentes
 
-//--------------------------------------------------------------------
-//--------------------------- AUTÓMATAS ------------------------------
-//--------------------------------------------------------------------
+    while(1){
 
-void automataID(char *charActual, token *tokenProcesado){
+        charActual = saltarEspacios(ficheroEntrada, &columna);
 
-    int estado = 0;
+        if(charActual == '#'){
+            while(charActual != '\n' && charActual != '\r' && charActual != EOF){
+                charActual = siguienteCaracter(ficheroEntrada);
+            }
+            continue;
+        }
+        else if(charActual == '\n' || charActual == '\r'){
+            // En un campo de un f-string separado que no es de triples comillas el salto de línea
+            // acaba el f-string (con un error), como en los f-strings que no se separan
+            while(lineas->numMarcos > 0 && !lineas->marcos[lineas->numMarcos - 1].triple){
+                stringSinCerrar();
+                cerrarCamposFstring(lineas);
+                lineas->numMarcos--;
+            }
 
-    /**
-     * AUTÓMATA PARA EL COMPONENTE LÉXICO ID
-     *  -> Estado 0: Inicial
-     *  -> Estado 1: Lectura de caracteres
-     *  -> Estado 2: Aceptación
-    */
-    while (estado != -1){
-        switch(estado){
+            if(lineas->enLinea && lineas->nivelParentesis == 0){
+                lineas->enLinea = 0;
+                moverInicioLexemaADelantero();
+                posicionInicioLexema(&tokenProcesado->posicion);
+                componenteEstructura(NEWLINE, tokenProcesado);
+                charActual = saltarFinLinea(charActual);
+                return 1;
+            }
 
-            case 0:
+            // Línea vacía o unión implícita dentro de paréntesis
+            columna = 0;
+            charActual = saltarFinLinea(charActual);
+            continue;
+        }
+        //Unión explícita de líneas: se saltan la barra invertida y el salto de línea que la sigue
+        else if(charActual == '\\'){
+            charActual = siguienteCaracter(ficheroEntrada);
 
-                if(isalpha(*charActual) || *charActual == '_'){
-                    estado = 1;
+            if(charActual == '\n' || charActual == '\r'){
+                charActual = saltarFinLinea(charActual);
+                continue;
+            }
 
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+            retrocederCaracter();
+            charActual = devolverDelantero();
+            break;
+        }
+        else if(charActual == '\0'){
+            charActual = siguienteCaracter(ficheroEntrada);
+            continue;
+        }
 
-                else return;
+        break;
+    }
 
-                break;
+    //Avanzamos el inicio hasta acabar los blancos y comentarios
+    moverInicioLexemaADelantero();
 
-            case 1:
+    // El componente empieza aquí (los INDENT y DEDENT en el primer componente de la línea y los del
+    // fin de la entrada en el EOF). La línea y la columna salen del índice de líneas del sistema de entrada
+    posicionInicioLexema(&tokenProcesado->posicion);
 
-                // isalnum devuelve 1 si el caracter es alfanumérico, mientras que isalpha 
-                // devuelve 1 si el caracter es una letra
-                if(isalnum(*charActual) || *charActual == '_'){
-                    estado = 1;
+    //-------------------- SANGRÍA --------------------
 
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    // El primer componente de una línea lógica compara su columna con el nivel de sangría actual
+    if(!lineas->enLinea && charActual != EOF){
 
-                else estado = 2;
+        int nivelActual = lineas->numSangrias > 0 ? lineas->sangrias[lineas->numSangrias - 1] : 0;
 
-                break;
+        lineas->enLinea = 1;
 
-            case 2:
+        if(columna > nivelActual){
+            if(lineas->numSangrias == MAX_SANGRIAS){
+                demasiadasSangrias();
+            } else {
+                lineas->sangrias[lineas->numSangrias++] = columna;
+                return componenteEstructura(INDENT, tokenProcesado);
+            }
+        }
+        else if(columna < nivelActual){
+            int niveles = 0;
 
-                retrocederCaracter();
+            while(lineas->numSangrias > 0 && columna < lineas->sangrias[lineas->numSangrias - 1]){
+                lineas->numSangrias--;
+                niveles++;
+            }
 
-                tokenProcesado->lexema = devolverLexema();
-                estado = -1;
+            if(columna != (lineas->numSangrias > 0 ? lineas->sangrias[lineas->numSangrias - 1] : 0)){
+                sangriaInconsistente();
+            }
 
-                break;
+            lineas->dedentsPendientes = niveles - 1;
+            return componenteEstructura(DEDENT, tokenProcesado);
         }
     }
-}
 
-int automataInts(char *charActual, token *tokenProcesado){
+    //-------------------- 1: CADENAS ALFANUMÉRICAS --------------------
 
-    int estado = 0;
+    // Si el caracter es una letra, podria ser el inicio de una cadema alfanumérica. Mientras la entrada
+    // sea ASCII se usa la variante del autómata que no trata caracteres multibyte
+    int ascii = entradaAscii();
 
-    int contadorParaRetroceder = 1;
+    if(ES_INICIO_ID(charActual) || (charActual >= 0x80 && !ascii)){
+        PERFIL_INICIO(inicioID);
+        int prefijo = ascii ? automataIDAscii(&charActual, tokenProcesado) : automataIDUtf8(&charActual, tokenProcesado);
+        PERFIL_FIN(tiempoAutomata[AUTOMATA_ID], inicioID);
+        PERFIL_CONTAR(llamadasAutomata[AUTOMATA_ID]);
 
-    /**
-    * Ver el autómata en la carpeta automatasPNG
-    *  -> Estado 0: Inicial
-    *  -> Estado 1, 2, 6, 7, 8  : Aceptación
-   */
-    while (1){
-        switch(estado){
-
-            case 0:
-                //ASCII del 1..9 
-                if(isdigit(*charActual) && *charActual != '0'){
-                    estado = 1;
-                    *charActual = siguienteCaracter(ficheroEntrada);
+        // Un byte que no empieza un caracter UTF-8 válido acaba como caracter no reconocido
+        if(prefijo != NO_ES_ID){
+            // Un prefijo (r, u, b, f, rb o rf) seguido de comillas empieza un string. El autómata se ha
+            // detenido en la comilla y el prefijo forma parte del lexema
+            if(prefijo != 0){
+                if((prefijo & PREFIJO_FORMATEADO) && lineas->separarFstrings && lineas->numMarcos < MAX_MARCOS_FSTRING){
+                    return iniciarFstring(&charActual, tokenProcesado, lineas, prefijo);
                 }
 
-                else if(*charActual == '0'){
-                    estado = 2;
-                    *charActual = siguienteCaracter(ficheroEntrada);
+                if(PERFIL_AUTOMATA(AUTOMATA_STRING, automataString(&charActual, tokenProcesado, prefijo))){
+                    charActual = siguienteCaracter(ficheroEntrada);
+
+                    return 1;
                 }
 
-                else {
-                    for(int i = 0; i < contadorParaRetroceder; i++) {
-                        retrocederCaracter();
+                // Solo falla si se acaba la entrada, se sigue con el fin de fichero
+                stringSinCerrar();
+            }
+            else {
+                // Si el autómata no ha reconocido una palabra reservada se busca el identificador en la tabla
+                if(tokenProcesado->componente == 0){
+                    tokenProcesado->componente = buscarSimbolo(tokenProcesado->lexema, *tabla, &tokenProcesado->simbolo);
+
+                    if(tokenProcesado->componente == 0){
+                        tokenProcesado->componente = ID;
+                        tokenProcesado->simbolo = insertarSimbolo(*tokenProcesado, tabla);
+                    }
+                    // Palabra reservada partida entre las dos mitades del buffer: su lexema también es constante
+                    else if(lexemaComponente(tokenProcesado->componente) != NULL){
+                        free(tokenProcesado->lexema);
+                        tokenProcesado->lexema = (char *) lexemaComponente(tokenProcesado->componente);
+                        tokenProcesado->simbolo = -1;
                     }
-
-                    return 0;
                 }
 
-                break;
+                charActual = siguienteCaracter(ficheroEntrada);
 
-            case 1:
+                return 1;
+            }
+        }
+    }
 
-                //ASCII del 0..9
-                while(isdigit(*charActual) || *charActual == '_'){
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                    contadorParaRetroceder++;
-                }
+    //-------------------- 2: NÚMEROS --------------------
 
-                if(!isdigit(*charActual) && *charActual != '_' && *charActual != '.' && *charActual != 'e' && *charActual != 'E'){
+    // Si el caracter es un número (o un '.' seguido de un dígito) es el inicio de un literal numérico.
+    // El componente (NUM_INT o NUM_FLOAT) lo decide el autómata. Tras un '.' se mira el siguiente
+    // caracter sin leerlo, así los '.' de los atributos van directamente a los delimitadores
+    if(ES_DIGITO(charActual) || (charActual == '.' && ES_DIGITO(mirarCaracter(ficheroEntrada, 1)))){
 
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
+        if(PERFIL_AUTOMATA(AUTOMATA_NUMEROS, automataNumeros(&charActual, tokenProcesado))){
 
-                    tokenProcesado->lexema = devolverLexema();
+            charActual = siguienteCaracter(ficheroEntrada);
 
-                    return 1;
-                } else {
+            return 1;
+        }
+    }
 
-                    for(int i = 0; i < contadorParaRetroceder; i++){
-                        retrocederCaracter();
-                        *charActual = devolverDelantero();
-                    }
+    //-------------------- 3: OPERADORES Y DELIMITADORES --------------------
 
-                    return 0;
-                }
+    // Un solo autómata reconoce el signo más largo y su componente a partir de su primer caracter
+    if(PERFIL_AUTOMATA(AUTOMATA_PUNTUACION, automataPuntuacion(&charActual, tokenProcesado))){
 
-            case 2:
+        // Dentro de paréntesis, corchetes o llaves los saltos de línea no acaban la línea lógica
+        if(tokenProcesado->componente == PARENTESIS_IZQ || tokenProcesado->componente == CORCHETE_IZQ
+           || tokenProcesado->componente == LLAVE_IZQ){
+            lineas->nivelParentesis++;
+        }
+        else if((tokenProcesado->componente == PARENTESIS_DER || tokenProcesado->componente == CORCHETE_DER
+                 || tokenProcesado->componente == LLAVE_DER) && lineas->nivelParentesis > 0){
+            lineas->nivelParentesis--;
+        }
 
-                if(*charActual == 'b' || *charActual == 'B'){
-                    estado = 3;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                    contadorParaRetroceder++;
-                }
+        // En un campo de un f-string separado, la '}' que lo cierra vuelve al texto del f-string y los
+        // ':' del nivel del campo empiezan la especificación de formato
+        if(lineas->numMarcos > 0 && lineas->marcos[lineas->numMarcos - 1].tipo == MARCO_CAMPO){
+            marcoFstring *campo = &lineas->marcos[lineas->numMarcos - 1];
 
-                else if (*charActual == 'o' || *charActual == 'O'){
-                    estado = 4;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                    contadorParaRetroceder++;
-                }
+            if(tokenProcesado->componente == LLAVE_DER && lineas->nivelParentesis < campo->nivelParentesis){
+                lineas->numMarcos--;
+            }
+            else if(tokenProcesado->componente == DOS_PUNTOS && lineas->nivelParentesis == campo->nivelParentesis){
+                campo->especificacion = 1;
+            }
+            // Como en Python, ':=' en el nivel del campo es ':' y una especificación que empieza por '=',
+            // que se queda en el delantero
+            else if(tokenProcesado->componente == MORSA && lineas->nivelParentesis == campo->nivelParentesis){
+                campo->especificacion = 1;
+                tokenProcesado->componente = DOS_PUNTOS;
+                tokenProcesado->lexema = (char *) lexemaComponente(DOS_PUNTOS);
 
-                else if (*charActual == 'x' || *charActual == 'X'){
-                    estado = 5;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                    contadorParaRetroceder++;
-                }
+                return 1;
+            }
+        }
 
-                else{
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
+        charActual = siguienteCaracter(ficheroEntrada);
 
-                    tokenProcesado->lexema = devolverLexema();
+        return 1;
+    }
 
-                    return 1;
-                }
+    //-------------------- 4: STRINGS --------------------
 
-                break;
+    // Si el caracter es una comilla es el inicio de un string sin prefijo (de una o de triples comillas)
+    if(charActual == '\"' || charActual == '\''){
+        if(PERFIL_AUTOMATA(AUTOMATA_STRING, automataString(&charActual, tokenProcesado, 0))){
 
-            case 3:
+            charActual = siguienteCaracter(ficheroEntrada);
 
-                if(*charActual == '0' || *charActual == '1'){
-                    estado = 6;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                    contadorParaRetroceder++;
-                }
+            return 1;
+        }
+        else if(charActual == EOF){
+            stringSinCerrar();
+        }
+    }
 
-                else if(*charActual == '_'){
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                    contadorParaRetroceder++;
-                    if(*charActual == '0' || *charActual == '1'){
-                        estado = 6;
-                    }
-                }
+    //-------------------- 5: FIN DE FICHERO o CARACTER DESCONOCIDO --------------------
 
-                else {
+    if(charActual == '\000' || charActual == EOF){
 
-                    for(int i = 0; i < contadorParaRetroceder; i++){
-                        retrocederCaracter();
-                        *charActual = devolverDelantero();
-                    }
-                    return 0;
-                }
+        // Los f-strings separados que siguen abiertos ya no se van a cerrar
+        if(lineas->numMarcos > 0){
+            stringSinCerrar();
+            lineas->numMarcos = 0;
+        }
 
-                break;
+        // Antes del EOF se acaba la última línea lógica y se cierran los niveles de sangría abiertos
+        if(lineas->enLinea){
+            lineas->enLinea = 0;
+            lineas->nivelParentesis = 0;
+            return componenteEstructura(NEWLINE, tokenProcesado);
+        }
 
-            case 4:
-                //ASCII del 0..8
-                if(isdigit(*charActual) && *charActual == '9'){
-                    estado = 7;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                    contadorParaRetroceder++;
-                }
+        if(lineas->numSangrias > 0){
+            lineas->dedentsPendientes = lineas->numSangrias - 1;
+            lineas->numSangrias = 0;
+            return componenteEstructura(DEDENT, tokenProcesado);
+        }
 
-                else if(*charActual == '_'){
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                    contadorParaRetroceder++;
-                    if(*charActual >= 48 && *charActual <= 56){
-                        estado = 7;
-                    }
-                }
+        // La siguiente entrada que se analice con este estado empieza de cero
+        reiniciarEstadoLineas(lineas);
+        tokenProcesado->componente = EOF;
 
-                else {
+        return 0;
 
-                    for(int i = 0; i < contadorParaRetroceder; i++){
-                        retrocederCaracter();
-                        *charActual = devolverDelantero();
-                    }
-                    return 0;
-                }
+    } else {
+        caracterNoReconocido(charActual);
 
-                break;
+        // Descartamos los caracteres hasta el siguiente que pueda empezar un componente, así la
+        // siguiente llamada continúa el análisis y una racha de caracteres erróneos es un solo error
+        tokenProcesado->componente = 0;
+        do {
+            charActual = siguienteCaracter(ficheroEntrada);
+        } while(!puntoSincronizacion(charActual));
+        moverInicioLexemaADelantero();
 
-            case 5:
-                //ASCII del 0..9, a..f y A..F
-                if(isdigit(*charActual)||
-                   (*charActual >= 97 && *charActual <= 102) ||
-                   (*charActual >= 65 && *charActual <= 70) ){
-                    estado = 8;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                    contadorParaRetroceder++;
-                }
+        return 0;
+    }
 
-                else if(*charActual == '_'){
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                    contadorParaRetroceder++;
-                    if(isdigit(*charActual) ||
-                       (*charActual >= 97 && *charActual <= 102) ||
-                       (*charActual >= 65 && *charActual <= 70) ){
-                        estado = 8;
-                    } else return 0;
-                }
+}
 
-                else {
 
-                    for(int i = 0; i < contadorParaRetroceder; i++){
-                        retrocederCaracter();
-                        *charActual = devolverDelantero();
-                    }
-                    return 0;
-                }
 
-                break;
 
-            case 6:
+//--------------------------------------------------------------------
+//--------------------------- AUTÓMATAS ------------------------------
+//--------------------------------------------------------------------
 
-                while(*charActual == '0' || *charActual == '1' || *charActual == '_'){
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                    contadorParaRetroceder++;
-                }
+// Las dos variantes del autómata de identificadores se generan a partir del mismo código
+#define CONCATENAR(a, b) a##b
+#define NOMBRE_CON_SUFIJO(nombre, sufijo) CONCATENAR(nombre, sufijo)
+#define NOMBRE_VARIANTE(nombre) NOMBRE_CON_SUFIJO(nombre, SUFIJO_VARIANTE)
+
+#define VARIANTE_ASCII 1
+#define SUFIJO_VARIANTE Ascii
+#include "automataID.h"
+#undef VARIANTE_ASCII
+#undef SUFIJO_VARIANTE
+
+#define VARIANTE_ASCII 0
+#define SUFIJO_VARIANTE Utf8
+#include "automataID.h"
+#undef VARIANTE_ASCII
+#undef SUFIJO_VARIANTE
+
+// Lee el caracter UTF-8 que empieza en el byte actual y deja en charActual el siguiente. Si los bytes no
+// forman un caracter válido (continuación que falta, forma larga, sustituto o más allá de U+10FFFF) o el
+// caracter no puede empezar (XID_Start) o continuar (XID_Continue) un identificador se vuelve al primero
+// y no se avanza
+int leerCaracterID(int *charActual, int inicio){
+
+    static const int32_t minimos[4] = { 0, 0x80, 0x800, 0x10000 };
+    int continuaciones;
+    int32_t codigo;
+
+    // Primer byte: indica cuántos bytes de continuación siguen
+    if(*charActual > 0xF4) return 0;
+    else if(*charActual >= 0xF0){ continuaciones = 3; codigo = *charActual & 0x07; }
+    else if(*charActual >= 0xE0){ continuaciones = 2; codigo = *charActual & 0x0F; }
+    else if(*charActual >= 0xC2){ continuaciones = 1; codigo = *charActual & 0x1F; }
+    else return 0;
+
+    marcaEntrada primerByte = marcarDelantero();
+    int c = *charActual;
+
+    for(int i = 0; i < continuaciones; i++){
+        c = siguienteCaracter(ficheroEntrada);
+
+        if((c & 0xC0) != 0x80 || c == EOF){
+            restaurarDelantero(primerByte);
+            return 0;
+        }
 
-                if(*charActual != '1' && *charActual != 0 && *charActual != '_' && *charActual != '.' && *charActual != 'e' && *charActual != 'E'){
-                    retrocederCaracter();
+        codigo = (codigo << 6) | (c & 0x3F);
+    }
 
-                    tokenProcesado->lexema = devolverLexema();
+    if(codigo < minimos[continuaciones] || (codigo >= 0xD800 && codigo <= 0xDFFF) || codigo > 0x10FFFF
+       || !(inicio ? esInicioIdentificador(codigo) : esParteIdentificador(codigo))){
+        restaurarDelantero(primerByte);
+        return 0;
+    }
 
-                    return 1;
-                }
+    *charActual = siguienteCaracter(ficheroEntrada);
 
-                else {
+    return continuaciones + 1;
+}
 
-                    for(int i = 0; i < contadorParaRetroceder; i++){
-                        retrocederCaracter();
-                        *charActual = devolverDelantero();
-                    }
+// Los prefijos válidos son r, u, b y f, y las combinaciones de r con b o f en cualquier orden
+int prefijoString(char primero, char segundo, int longitud){
 
-                    return 0;
-                }
+    char caracteres[2] = { primero, segundo };
+    int prefijos[2] = { 0, 0 };
 
+    for(int i = 0; i < longitud; i++){
+        switch(caracteres[i] | 0x20){
+            case 'r': prefijos[i] = PREFIJO_CRUDO; break;
+            case 'u': prefijos[i] = PREFIJO_UNICODE; break;
+            case 'b': prefijos[i] = PREFIJO_BYTES; break;
+            case 'f': prefijos[i] = PREFIJO_FORMATEADO; break;
+            default: return 0;
+        }
+    }
 
-            case 7:
-                //ASCII del 0..8
-                while((isdigit(*charActual) && *charActual!='8') || *charActual == '_'){
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                    contadorParaRetroceder++;
-                }
+    if(longitud == 1) return prefijos[0];
 
-                if(!(*charActual >= 48 && *charActual <= 56) && *charActual != '_' && *charActual != '.' && *charActual != 'e' && *charActual != 'E'){
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
+    if((prefijos[0] | prefijos[1]) == (PREFIJO_CRUDO | PREFIJO_BYTES) || (prefijos[0] | prefijos[1]) == (PREFIJO_CRUDO | PREFIJO_FORMATEADO)){
+        return prefijos[0] | prefijos[1];
+    }
 
-                    tokenProcesado->lexema = devolverLexema();
+    return 0;
+}
 
-                    return 1;
-                }
+int automataNumeros(int *charActual, token *tokenProcesado){
 
-                else {
+    int base = 10; // Base de los dígitos del entero
+    int malFormado = 0; // El literal no es válido en Python, se devuelve igualmente con un error
+    int ceroInicial = 0; // Entero decimal que empieza por 0 (solo es válido si todos sus dígitos son 0)
+    int digitoNoNulo = 0;
+    int64_t entero = 0;
+    int enteroGrande = 0; // El entero no cabe en int64_t
+    int componenteMantisa = NUM_INT; // Componente del literal si la 'e' no resulta ser un exponente
+    marcaEntrada exponente = 0; // Posición de la 'e', para volver a ella si no sigue un exponente
+    int digito;
 
-                    for(int i = 0; i < contadorParaRetroceder; i++){
-                        retrocederCaracter();
-                        *charActual = devolverDelantero();
-                    }
-                    return 0;
-                }
+    /**
+     * Autómata único para todos los literales numéricos. Lee cada caracter una sola vez:
+     * solo se retrocede el caracter que sigue al literal, como en el resto de autómatas, salvo
+     * si tras una 'e' no hay exponente (como en 1else): entonces se vuelve a la marca de la 'e'
+     *  -> Estado 0: Inicial ('.' inicial: el analizador ya ha visto que le sigue un dígito)
+     *  -> Estado 1: Dígitos de la parte entera decimal (Aceptación: entero)
+     *  -> Estado 2: Tras un '0' inicial, puede venir el prefijo de base (Aceptación: entero)
+     *  -> Estado 3: Dígitos de un entero hexadecimal, octal o binario (Aceptación: entero)
+     *  -> Estado 4: Dígitos de la parte fraccionaria (Aceptación: real)
+     *  -> Estado 5: Tras 'e' o 'E', puede venir el signo y tiene que seguir un dígito
+     *  -> Estado 6: Dígitos del exponente (Aceptación: real)
+     *  -> Estado 7: Tras 'j' o 'J' (Aceptación: imaginario)
+    */
+    AUTOMATA(0){
 
-            case 8:
-                while(isdigit(*charActual) ||
-                      (*charActual >= 97 && *charActual <= 102) ||
-                      (*charActual >= 65 && *charActual <= 70) || *charActual == '_'){
+        ESTADO(0):
 
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                    contadorParaRetroceder++;
+            if(*charActual == '0'){
+                ceroInicial = 1;
+                *charActual = siguienteCaracter(ficheroEntrada);
+                IR_A(2);
+            }
+            else if(ES_DIGITO(*charActual)){
+                entero = *charActual - '0';
+                digitoNoNulo = 1;
+                *charActual = siguienteCaracter(ficheroEntrada);
+                IR_A(1);
+            }
+            else if(*charActual == '.'){
+                *charActual = siguienteCaracter(ficheroEntrada);
+                IR_A(4);
+            }
 
-                }
+            return 0;
 
-                if(!(isdigit(*charActual) ||
-                     (*charActual >= 97 && *charActual <= 102) ||
-                     (*charActual >= 65 && *charActual <= 70) ) && *charActual != '_' && *charActual != '.' && *charActual != 'e' && *charActual != 'E'){
+        ESTADO(2):
 
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
+            if(*charActual == 'x' || *charActual == 'X' || *charActual == 'o' || *charActual == 'O' ||
+               *charActual == 'b' || *charActual == 'B'){
+                base = (*charActual == 'x' || *charActual == 'X') ? 16 : (*charActual == 'o' || *charActual == 'O') ? 8 : 2;
 
-                    tokenProcesado->lexema = devolverLexema();
-                    return 1;
+                // Tiene que haber al menos un dígito (se puede separar del prefijo con '_')
+                *charActual = siguienteCaracter(ficheroEntrada);
+                if(*charActual == '_'){
+                    *charActual = siguienteCaracter(ficheroEntrada);
                 }
+                digito = valorDigito(*charActual);
+                if(digito < 0 || digito >= base) malFormado = 1;
+                IR_A(3);
+            }
 
-                else {
-                    for(int i = 0; i < contadorParaRetroceder; i++){
-                        retrocederCaracter();
-                        *charActual = devolverDelantero();
-                    }
-                    return 0;
-                }
+            // Sin prefijo de base sigue como un entero decimal
 
-        }
-    }
-}
+        ESTADO(1):
 
-int automataFloats(char *charActual, token *tokenProcesado){
+            if(ES_DIGITO(*charActual)){
+                if(*charActual != '0') digitoNoNulo = 1;
+                if(entero > (INT64_MAX - (*charActual - '0')) / 10) enteroGrande = 1;
+                else entero = entero * 10 + (*charActual - '0');
+                *charActual = siguienteCaracter(ficheroEntrada);
+                IR_A(1);
+            }
+            else if(*charActual == '_'){
+                malFormado |= saltarGuion(charActual, base);
+                IR_A(1);
+            }
+            else if(*charActual == '.'){
+                *charActual = siguienteCaracter(ficheroEntrada);
+                IR_A(4);
+            }
+            else if(*charActual == 'e' || *charActual == 'E'){
+                exponente = marcarDelantero();
+                *charActual = siguienteCaracter(ficheroEntrada);
+                IR_A(5);
+            }
+            else if(*charActual == 'j' || *charActual == 'J'){
+                *charActual = siguienteCaracter(ficheroEntrada);
+                IR_A(7);
+            }
 
-    int estado = 0;
+            // Python no admite enteros decimales como 012
+            if(ceroInicial && digitoNoNulo) malFormado = 1;
+            return aceptarNumero(charActual, tokenProcesado, NUM_INT, enteroGrande, entero, malFormado);
 
+        ESTADO(3):
 
-    /**
-    * Ver el autómata en la carpeta automatasPNG (Los estados 2 y 3 se colapsan en uno)
-    *  -> Estado 0: Inicial
-    *  -> Estado 1, 2, 3  : Aceptación
-   */
-    while (1){
-        switch(estado){
-
-            case 0:
-                //ASCII del 0..9
-                if(isdigit(*charActual)){
-                    estado = 0;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+            digito = valorDigito(*charActual);
 
-                else if(*charActual == '.'){
-                    estado = 1;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+            if(digito >= 0 && digito < base){
+                if(entero > (INT64_MAX - digito) / base) enteroGrande = 1;
+                else entero = entero * base + digito;
+            }
+            else if(*charActual == '_'){
+                malFormado |= saltarGuion(charActual, base);
+                IR_A(3);
+            }
+            else if(digito >= 0 && digito < 10) malFormado = 1; // Por ejemplo el 2 de 0b12
+            else return aceptarNumero(charActual, tokenProcesado, NUM_INT, enteroGrande, entero, malFormado);
 
-                else if(*charActual == 'e' || *charActual == 'E'){
-                    estado = 2;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+            *charActual = siguienteCaracter(ficheroEntrada);
+            IR_A(3);
 
-                else return 0;
+        ESTADO(4):
 
-                break;
+            if(ES_DIGITO(*charActual)){
+                *charActual = siguienteCaracter(ficheroEntrada);
+                IR_A(4);
+            }
+            else if(*charActual == '_'){
+                malFormado |= saltarGuion(charActual, base);
+                IR_A(4);
+            }
+            else if(*charActual == 'e' || *charActual == 'E'){
+                componenteMantisa = NUM_FLOAT;
+                exponente = marcarDelantero();
+                *charActual = siguienteCaracter(ficheroEntrada);
+                IR_A(5);
+            }
+            else if(*charActual == 'j' || *charActual == 'J'){
+                *charActual = siguienteCaracter(ficheroEntrada);
+                IR_A(7);
+            }
 
-            case 1:
-                //ASCII del 0..9
-                while(isdigit(*charActual) || *charActual == '_'){
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+            return aceptarNumero(charActual, tokenProcesado, NUM_FLOAT, 0, 0, malFormado);
 
-                if(*charActual == 'j'){
-                    estado = 4;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                } 
+        ESTADO(5):
 
-                else{
+            if(*charActual == '+' || *charActual == '-'){
+                *charActual = siguienteCaracter(ficheroEntrada);
+            }
 
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
+            // Sin dígitos la 'e' no forma parte del literal: se vuelve a ella y el literal acaba antes
+            if(!ES_DIGITO(*charActual)){
+                restaurarDelantero(exponente);
+                *charActual = devolverDelantero();
 
-                    tokenProcesado->lexema = devolverLexema();
-                    return 1;
-                }
+                if(componenteMantisa == NUM_INT && ceroInicial && digitoNoNulo) malFormado = 1;
 
-                break;
+                return aceptarNumero(charActual, tokenProcesado, componenteMantisa, enteroGrande, entero, malFormado);
+            }
 
-            case 2:
-                //ASCII del 0..9
-                while(isdigit(*charActual) || *charActual == '+' || *charActual == '-' || *charActual == '_'){
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+            // Sigue con los dígitos del exponente
 
-                if(*charActual == 'j'){
-                    estado = 4;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+        ESTADO(6):
 
-                else{
-                    retrocederCaracter();
+            if(ES_DIGITO(*charActual)){
+                *charActual = siguienteCaracter(ficheroEntrada);
+                IR_A(6);
+            }
+            else if(*charActual == '_'){
+                malFormado |= saltarGuion(charActual, base);
+                IR_A(6);
+            }
+            else if(*charActual == 'j' || *charActual == 'J'){
+                *charActual = siguienteCaracter(ficheroEntrada);
+                IR_A(7);
+            }
 
-                    tokenProcesado->lexema = devolverLexema();
-                    return 1;
-                }
+            return aceptarNumero(charActual, tokenProcesado, NUM_FLOAT, 0, 0, malFormado);
 
-                break;
+        ESTADO(7):
 
-        }
+            return aceptarNumero(charActual, tokenProcesado, NUM_FLOAT, 0, 0, malFormado);
     }
-}
 
-int automataOp(char *charActual, token *tokenProcesado){
+    return 0;
+}
 
-    int estado = 0;
+int aceptarNumero(int *charActual, token *tokenProcesado, int componente, int enteroGrande, int64_t entero, int malFormado){
 
-    /**
-     * Ver el autómata en la carpeta automatasPNG
-     *  -> Estado 0: Inicial
-     *  -> Estado 10: Aceptación
-    */
-    while(1){
-        switch(estado){
+    // El caracter actual ya no forma parte del literal
+    retrocederCaracter();
+    *charActual = devolverDelantero();
 
-            case 0:
+    if(malFormado) numeroMalFormado();
 
-                if(*charActual == '+'|| *charActual == '%' || *charActual == '&' || *charActual == '|' || *charActual == '@' || *charActual == '^'){
-                    estado = 1;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    tokenProcesado->componente = componente;
+    tokenProcesado->lexema = devolverLexema();
 
-                else if (*charActual == '*'){
-                    estado = 2;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    if(tokenProcesado->lexema == NULL) return 1;
 
-                else if (*charActual == '~'){
-                    estado = 10;
-                }
+    if(componente == NUM_INT && !enteroGrande){
+        tokenProcesado->valor.tipo = VALOR_ENTERO;
+        tokenProcesado->valor.entero = entero;
+        tokenProcesado->valor.real = (double) entero;
+        return 1;
+    }
 
-                else if (*charActual == '/'){
-                    estado = 4;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    // Los reales (y los enteros que no caben en int64_t, de forma aproximada) se convierten
+    // una sola vez a partir del lexema, quitando los '_' y la 'j' final
+    char copia[64], *texto = copia;
+    size_t longitud = strlen(tokenProcesado->lexema), j = 0;
 
-                else if (*charActual == ':' || *charActual == '=' || *charActual == '!'){
-                    estado = 5;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    if(longitud >= sizeof(copia) && (texto = (char *) malloc(longitud + 1)) == NULL){
+        errorMemoria();
+        return 1;
+    }
 
-                else if (*charActual == '>'){
-                    estado = 6;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    for(size_t i = 0; i < longitud; i++){
+        if(tokenProcesado->lexema[i] != '_' && tokenProcesado->lexema[i] != 'j' && tokenProcesado->lexema[i] != 'J'){
+            texto[j++] = tokenProcesado->lexema[i];
+        }
+    }
+    texto[j] = '\0';
 
-                else if (*charActual == '<'){
-                    estado = 7;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    if(componente == NUM_INT){
+        tokenProcesado->valor.tipo = VALOR_ENTERO_GRANDE;
+        tokenProcesado->valor.entero = INT64_MAX;
+    } else {
+        // Si el literal excede el buffer el lexema conservado puede estar vacío
+        char ultimo = longitud > 0 ? tokenProcesado->lexema[longitud - 1] : '\0';
+        tokenProcesado->valor.tipo = (ultimo == 'j' || ultimo == 'J') ? VALOR_IMAGINARIO : VALOR_REAL;
+        tokenProcesado->valor.entero = 0;
+    }
 
-                else if(*charActual == '-' ){
-                    estado = 9;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    // Con base 16, 8 o 2 strtod no sirve, el valor aproximado se calcula dígito a dígito
+    if(componente == NUM_INT && j > 1 && texto[0] == '0' && ES_LETRA(texto[1])){
+        int base = (texto[1] == 'x' || texto[1] == 'X') ? 16 : (texto[1] == 'o' || texto[1] == 'O') ? 8 : 2;
+        double real = 0;
 
-                else return 0;
+        for(size_t i = 2; i < j && valorDigito(texto[i]) >= 0; i++) real = real * base + valorDigito(texto[i]);
+        tokenProcesado->valor.real = real;
+    } else {
+        tokenProcesado->valor.real = strtod(texto, NULL);
+    }
 
-                break;
+    if(texto != copia) free(texto);
 
-            case 1:
+    return 1;
+}
 
-                if(*charActual != '='){
-                    estado = 10;
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                } else {
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
+// Salta un '_' de un literal, que solo puede ir entre dos dígitos de la base. Devuelve 1 si no le sigue uno
+int saltarGuion(int *charActual, int base){
 
-                    return 0;
-                }
+    *charActual = siguienteCaracter(ficheroEntrada);
 
-                break;
+    int digito = valorDigito(*charActual);
 
-            case 2:
-                if(*charActual == '*'){
-                    estado = 3;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    return digito < 0 || digito >= base;
+}
 
-                else if (*charActual != '='){
-                    estado = 10;
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                }
+int valorDigito(int c){
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
 
-                else {
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                    return 0;
-                }
+// Acepta la forma indicada del signo: el lexema es constante, solo se avanza el inicio del lexema
+int aceptarSigno(const signoPuntuacion *signo, int forma, token *tokenProcesado){
 
-                break;
+    tokenProcesado->componente = signo->componente[forma];
+    tokenProcesado->lexema = (char *) lexemasSignos[tokenProcesado->componente - PRIMER_SIGNO];
+    moverInicioLexemaADelantero();
 
-            case 3:
+    return 1;
+}
 
-                if(*charActual != '='){
-                    estado = 10;
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                } else {
-                    //Retrocedemos dos veces porque el automata leyo '**'
-                    retrocederCaracter();
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                    return 0;
-                }
+int automataPuntuacion(int *charActual, token *tokenProcesado){
 
-                break;
+    unsigned char primero = (unsigned char) *charActual;
 
-            case 4:
+    if(primero >= 128 || signosPuntuacion[primero].componente[SIGNO_SOLO] == 0){
+        return 0;
+    }
 
-                if(*charActual == '/'){
-                    estado = 8;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    const signoPuntuacion *signo = &signosPuntuacion[primero];
 
-                else if (*charActual != '='){
-                    estado = 10;
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                }
+    // Los signos de un solo caracter no necesitan leer el siguiente
+    if(signo->componente[SIGNO_CON_IGUAL] == 0 && signo->componente[SIGNO_DOBLE] == 0 && signo->componente[SIGNO_TRIPLE] == 0){
+        return aceptarSigno(signo, SIGNO_SOLO, tokenProcesado);
+    }
 
-                else {
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                    return 0;
-                }
+    /**
+     * Se busca la coincidencia más larga mirando los caracteres siguientes sin leerlos, así que solo
+     * se avanza el delantero sobre los que forman parte del signo y no hay que retroceder: en '..' el
+     * tercer caracter no es un '.' y se devuelve un solo PUNTO
+    */
+    int segundo = mirarCaracter(ficheroEntrada, 1);
 
-                break;
+    if(signo->componente[SIGNO_TRIPLE] != 0 && segundo == primero && mirarCaracter(ficheroEntrada, 2) == primero){
+        siguienteCaracter(ficheroEntrada);
+        *charActual = siguienteCaracter(ficheroEntrada);
+        return aceptarSigno(signo, SIGNO_TRIPLE, tokenProcesado);
+    }
 
-            case 5:
+    if(segundo == '=' && signo->componente[SIGNO_CON_IGUAL] != 0){
+        *charActual = siguienteCaracter(ficheroEntrada);
+        return aceptarSigno(signo, SIGNO_CON_IGUAL, tokenProcesado);
+    }
 
-                if(*charActual == '='){
-                    estado = 10;
-                } else {
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                    return 0;
-                }
+    // El segundo caracter de la forma doble ('*' en '**', '>' en '->') se saca de su lexema
+    if(signo->componente[SIGNO_DOBLE] != 0 && segundo == lexemasSignos[signo->componente[SIGNO_DOBLE] - PRIMER_SIGNO][1]){
 
-                break;
+        int forma = SIGNO_DOBLE;
 
-            case 6:
+        if(signo->componente[SIGNO_DOBLE_CON_IGUAL] != 0 && mirarCaracter(ficheroEntrada, 2) == '='){
+            forma = SIGNO_DOBLE_CON_IGUAL;
+            siguienteCaracter(ficheroEntrada);
+        }
 
-                if(*charActual == '>'){
-                    estado = 8;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+        *charActual = siguienteCaracter(ficheroEntrada);
+        return aceptarSigno(signo, forma, tokenProcesado);
+    }
 
-                else if(*charActual == '='){
-                    estado = 10;
-                }
+    return aceptarSigno(signo, SIGNO_SOLO, tokenProcesado);
+}
 
-                else {
-                    estado = 10;
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                }
+// Devuelve un componente de la estructura de líneas, no consume ningún caracter
+int componenteEstructura(int componente, token *tokenProcesado){
 
-                break;
+    tokenProcesado->componente = componente;
+    tokenProcesado->lexema = (char *) lexemaComponente(componente);
 
-            case 7:
+    return 1;
+}
 
-                if(*charActual == '<'){
-                    estado = 8;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+// En "\r\n" se salta también el '\n' que sigue al '\r'
+int saltarFinLinea(int c){
 
-                else if(*charActual == '='){
-                    estado = 10;
-                }
+    if(c == '\r' && mirarCaracter(ficheroEntrada, 1) == '\n') siguienteCaracter(ficheroEntrada);
 
-                else {
-                    estado = 10;
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                }
+    return siguienteCaracter(ficheroEntrada);
+}
 
-                break;
+// Busca la palabra reservada comparando primero la longitud y el primer caracter
+int palabraReservada(const char *inicio, size_t longitud){
 
-            case 8:
+    for(int i = 0; i < sizeof(palabrasReservadas)/sizeof(palabrasReservadas[0]); i++){
+        if(palabrasReservadas[i].longitud == longitud && palabrasReservadas[i].lexema[0] == inicio[0]
+           && memcmp(palabrasReservadas[i].lexema, inicio, longitud) == 0){
+            return palabrasReservadas[i].componente;
+        }
+    }
 
-                if(*charActual != '='){
-                    estado = 10;
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                } else { // Retrocedemos dos veces porque el automata leyo '<<' o '>>' o '//'
-                    retrocederCaracter();
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                    return 0;
-                }
-                break;
-
-            case 9:
-
-                if(*charActual != '=' && *charActual != '>'){
-                    estado = 10;
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                } else {
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                    return 0;
-                }
+    return 0;
+}
 
-                break;
+// Devuelve el lexema constante de las palabras reservadas y de los signos
+const char *lexemaComponente(int componente){
 
-            case 10:
+    if(componente >= PRIMER_SIGNO && componente <= ULTIMO_SIGNO){
+        return lexemasSignos[componente - PRIMER_SIGNO];
+    }
 
-                tokenProcesado->lexema = devolverLexema();
-                return 1;
+    if(componente >= PRIMERA_PALABRA_RESERVADA && componente <= ULTIMA_PALABRA_RESERVADA){
+        return lexemasPalabras[componente - PRIMERA_PALABRA_RESERVADA];
+    }
 
-        }
+    switch(componente){
+        case NEWLINE: return "NEWLINE";
+        case INDENT: return "INDENT";
+        case DEDENT: return "DEDENT";
     }
-}
 
-int automataDel(char *charActual, token *tokenProcesado){
+    return NULL;
+}
 
-    int estado = 0;
+// Devuelve la clase (OP o DEL) de un signo de puntuación
+int claseSigno(int componente){
 
-    //Ver el automata en la carpeta automatasPNG
-    /**
-     * estado 0: Inicial
-     * estado 10: Aceptación
-    */
-    while(1){
-        switch(estado){
+    if(componente >= PRIMER_SIGNO && componente <= ULTIMO_SIGNO){
+        return clasesSignos[componente - PRIMER_SIGNO];
+    }
 
-            //Incial
-            case 0:
-                if(*charActual == '(' || *charActual == ')' || *charActual == '{' || *charActual == '}' || *charActual == '['
-                   || *charActual == ']' || *charActual == ',' || *charActual == ';' || *charActual == '.'){
-                    estado = 10;
-                }
+    return 0;
+}
 
-                else if( *charActual == '^' || *charActual == '&' || *charActual == '|'
-                         || *charActual == '@' || *charActual == '%' || *charActual == '+'){
-                    estado = 1;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+// Selecciona el estado de líneas del hilo
+void seleccionarEstadoLineas(estadoLineas *estado){
+    estadoActual = estado;
+}
 
-                else if (*charActual == ':' || *charActual == '='){
-                    estado = 2;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+// Deja el estado de líneas como al inicio de una entrada, la opción de separar los f-strings se conserva
+void reiniciarEstadoLineas(estadoLineas *estado){
 
-                else if (*charActual == '-'){
-                    estado = 3;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    int separar = estado->separarFstrings;
 
-                else if (*charActual == '/'){
-                    estado = 4;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    memset(estado, 0, sizeof(estadoLineas));
+    estado->separarFstrings = separar;
+}
 
-                else if (*charActual == '<'){
-                    estado = 5;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+// Activa o desactiva la separación de los f-strings
+void separarFstrings(estadoLineas *estado, int separar){
+    (estado != NULL ? estado : &estadoPorDefecto)->separarFstrings = separar;
+}
 
-                else if (*charActual == '>'){
-                    estado = 6;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+// Indica si el lexema del componente es una cadena constante que no se debe liberar
+int lexemaConstante(const token *t){
+    return lexemaComponente(t->componente) != NULL || t->componente == FSTRING_FIN;
+}
 
-                else if (*charActual == '*'){
-                    estado = 7;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+int automataString(int *charActual, token *tokenProcesado, int prefijo){
 
-                else return 0;
-                break;
+    /**
+     * El inicio del lexema está en el prefijo (si lo hay) y el delantero en la comilla de apertura.
+     * El string se recorre hasta su comilla de cierre, que queda en el delantero
+    */
+    if(!escanearString(charActual, prefijo)){
+        return 0;
+    }
 
-            case 1:
+    tokenProcesado->componente = STRING;
+    tokenProcesado->lexema = devolverLexema();
 
-                if(*charActual == '='){
-                    estado = 10;
+    return 1;
+}
 
-                }  else {
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                    return 0;
-                }
+int escanearString(int *charActual, int prefijo){
 
-                break;
+    char comilla = *charActual;
+    int triple = 0;
+    int formateado = (prefijo & PREFIJO_FORMATEADO) != 0;
 
-            case 2:
+    /**
+     * Tras la comilla de apertura:
+     *  -> Otra comilla y un caracter distinto: string vacío, se retrocede ese caracter
+     *  -> Otras dos comillas: string de triples comillas, puede ocupar varias líneas
+    */
+    *charActual = siguienteCaracter(ficheroEntrada);
 
-                if(*charActual != '='){
-                    estado = 10;
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                }  else {
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                    return 0;
-                }
+    if(*charActual == comilla){
+        *charActual = siguienteCaracter(ficheroEntrada);
 
-                break;
+        if(*charActual != comilla){
+            retrocederCaracter();
+            *charActual = devolverDelantero();
 
-            case 3:
+            return 1;
+        }
 
-                if(*charActual == '=' || *charActual == '>'){
-                    estado = 10;
-                }  else {
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                    return 0;
-                }
+        triple = 1;
+        *charActual = siguienteCaracter(ficheroEntrada);
+    }
 
-                break;
+    /**
+     * El contenido se salta en bloque hasta el siguiente caracter que puede cambiar el estado: la
+     * comilla, la barra invertida, el salto de línea ('\n' o '\r', salvo en triples comillas) y la
+     * llave de apertura de los campos de sustitución de los f-strings
+    */
+    while(1){
 
-            case 4:
+        *charActual = avanzarHasta(ficheroEntrada, comilla, '\\', formateado ? '{' : comilla, triple ? comilla : '\n',
+                                   triple ? comilla : '\r');
 
-                if(*charActual == '/'){
-                    estado = 8;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+        if(*charActual == comilla){
+            int seguidas = 1;
 
-                else if(*charActual == '='){
-                    estado = 10;
-                }
+            if(!triple) return 1;
 
-                else {
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                    return 0;
-                }
+            while(seguidas < 3 && (*charActual = siguienteCaracter(ficheroEntrada)) == comilla){
+                seguidas++;
+            }
 
-                break;
+            if(seguidas == 3) return 1;
+        }
+        else if(*charActual == '\\'){
+            *charActual = saltarEscape(comilla, formateado, prefijo & PREFIJO_CRUDO);
+        }
+        else if(*charActual == '{'){
+            // '{{' es una llave en el texto, '{' sola abre un campo
+            *charActual = siguienteCaracter(ficheroEntrada);
 
-            case 5:
+            if(*charActual == '{'){
+                *charActual = siguienteCaracter(ficheroEntrada);
+            }
+            else if(!saltarCampoFstring(charActual, comilla, triple)){
+                return 0;
+            }
+        }
+        else if(*charActual == '\n' || *charActual == '\r'){
+            // El string acaba con la línea: se devuelve hasta el caracter anterior al salto de línea
+            stringSinCerrar();
+            retrocederCaracter();
+            *charActual = devolverDelantero();
 
-                if(*charActual == '<'){
-                    estado = 8;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }  else {
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                    return 0;
-                }
+            return 1;
+        }
+        else return 0;
+    }
+}
 
-                break;
+// El caracter escapado no cierra el string aunque sea una comilla (tampoco en los strings crudos).
+// En un f-string no crudo las llaves de \N{...} son parte del nombre del caracter y no un campo
+int saltarEscape(char comilla, int formateado, int crudo){
 
-            case 6:
+    int c = siguienteCaracter(ficheroEntrada);
 
-                if(*charActual == '>'){
-                    estado = 8;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                } else {
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                    return 0;
-                }
+    if(formateado && !crudo && c == 'N'){
+        c = siguienteCaracter(ficheroEntrada);
 
-                break;
+        if(c == '{'){
+            c = avanzarHasta(ficheroEntrada, '}', comilla, '\n', '\r', '}');
+            if(c == '}') c = siguienteCaracter(ficheroEntrada);
+        }
 
-            case 7:
+        return c;
+    }
 
-                if(*charActual == '*'){
-                    estado = 8;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    // Una barra invertida al final de una línea "\r\n" escapa los dos caracteres
+    if(c == '\r' && mirarCaracter(ficheroEntrada, 1) == '\n') c = siguienteCaracter(ficheroEntrada);
 
-                else if(*charActual == '='){
-                    estado = 10;
-                }
+    // Tras una barra invertida, una llave de un f-string sigue abriendo un campo
+    if(c != EOF && !(formateado && c == '{')){
+        c = siguienteCaracter(ficheroEntrada);
+    }
 
-                else {
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                    return 0;
-                }
+    return c;
+}
 
-                break;
+int saltarCampoFstring(int *charActual, char comilla, int triple){
 
-            case 8:
+    int nivel = 0; // Paréntesis, corchetes y llaves abiertos en la expresión
+    int especificacion = 0; // Se ha llegado a la especificación de formato
+    char anterior = 0;
 
-                if(*charActual == '='){
-                    estado = 10;
-                }  else { // Retrocedemos dos veces porque el automata leyo '//' o '<<' o '>>' o '**'
-                    retrocederCaracter();
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
-                    return 0;
-                }
+    /**
+     * El delantero está en el caracter que sigue a la '{' del campo y se deja en el que sigue a su
+     * '}'. Los strings de la expresión se saltan enteros (pueden usar las mismas comillas que el
+     * f-string, como en Python 3.12) y en la especificación de formato puede haber campos anidados.
+     * Devuelve 0 si se acaba la entrada
+    */
+    while(*charActual != EOF){
 
-                break;
+        // Un f-string que no es de triples comillas no pasa de la línea aunque tenga un campo abierto
+        if((*charActual == '\n' || *charActual == '\r') && !triple) return 1;
 
-            case 10:
+        if(especificacion){
+            if(*charActual == '{'){
+                *charActual = siguienteCaracter(ficheroEntrada);
+                if(!saltarCampoFstring(charActual, comilla, triple)) return 0;
+                continue;
+            }
 
-                tokenProcesado->lexema = devolverLexema();
+            if(*charActual == '}'){
+                *charActual = siguienteCaracter(ficheroEntrada);
+                return 1;
+            }
 
+            // Las comillas acaban el f-string con el campo abierto, lo trata quien llama
+            if(*charActual == comilla) return 1;
+        }
+        else if(*charActual == '\"' || *charActual == '\''){
+            // Un string de la expresión es un f-string si su prefijo acaba en f
+            if(!escanearString(charActual, (anterior == 'f' || anterior == 'F') ? PREFIJO_FORMATEADO : 0)) return 0;
+        }
+        else if(*charActual == '(' || *charActual == '[' || *charActual == '{'){
+            nivel++;
+        }
+        else if(*charActual == ')' || *charActual == ']' || *charActual == '}'){
+            if(nivel > 0){
+                nivel--;
+            }
+            else if(*charActual == '}'){
+                *charActual = siguienteCaracter(ficheroEntrada);
                 return 1;
+            }
         }
+        else if(*charActual == ':' && nivel == 0){
+            especificacion = 1;
+        }
+
+        anterior = *charActual;
+        *charActual = siguienteCaracter(ficheroEntrada);
     }
+
+    return 0;
 }
 
-int automataString(char *charActual, token *tokenProcesado){
+int iniciarFstring(int *charActual, token *tokenProcesado, estadoLineas *lineas, int prefijo){
+
+    marcoFstring *marco = &lineas->marcos[lineas->numMarcos++];
 
-    int estado = 0;
+    *marco = (marcoFstring) { .tipo = MARCO_TEXTO, .comilla = *charActual, .crudo = (prefijo & PREFIJO_CRUDO) != 0 };
+
+    tokenProcesado->componente = FSTRING_INICIO;
 
     /**
-     * Ver automata en automatasPNG
-     * Estado 0: Inicial
-     * Estados 4,6: Finales
+     * El lexema es el prefijo con las comillas de apertura y el delantero se deja en el primer
+     * caracter del texto. En un f-string vacío la segunda comilla ya es la de cierre
     */
-    while(1){
+    *charActual = siguienteCaracter(ficheroEntrada);
 
-        switch (estado){
+    if(*charActual == marco->comilla){
+        *charActual = siguienteCaracter(ficheroEntrada);
 
-            case 0:
+        if(*charActual == marco->comilla){
+            marco->triple = 1;
+            tokenProcesado->lexema = devolverLexema();
+            *charActual = siguienteCaracter(ficheroEntrada);
 
-                if(*charActual == '\"'){
-                    estado = 1;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
-
-                else if(*charActual == '\''){
-                    estado = 2;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+            return 1;
+        }
 
-                else{
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
+        retrocederCaracter();
+        tokenProcesado->lexema = devolverLexema();
+        if(tokenProcesado->lexema != NULL) tokenProcesado->lexema[strlen(tokenProcesado->lexema) - 1] = '\0';
+        *charActual = devolverDelantero();
+        marco->finPendiente = 1;
 
-                    return 0;
-                }
+        return 1;
+    }
 
-                break;
+    retrocederCaracter();
+    tokenProcesado->lexema = devolverLexema();
+    *charActual = siguienteCaracter(ficheroEntrada);
 
-            case 1:
+    return 1;
+}
 
-                if(*charActual != '\"'){
-                    estado = 3;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+int automataTextoFstring(token *tokenProcesado, estadoLineas *lineas){
 
-                else{
-                    estado = 4;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    marcoFstring *marco = &lineas->marcos[lineas->numMarcos - 1];
+    int texto = 0; // Se ha leído texto que aún no se ha devuelto
+    int c = devolverDelantero();
 
-                break;
+    moverInicioLexemaADelantero();
+    posicionInicioLexema(&tokenProcesado->posicion);
 
-            case 2:
+    if(marco->finPendiente){
+        return finFstring(tokenProcesado, lineas);
+    }
 
-                if(*charActual != '\''){
-                    estado = 4;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                } else{
-                    estado = 5;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    /**
+     * Se recorre el texto (o la especificación de formato del campo actual) hasta el siguiente
+     * caracter que cambia el estado. Si antes de él hay texto, primero se devuelve como
+     * FSTRING_MEDIO y el caracter se vuelve a tratar en la siguiente llamada:
+     *  -> Comillas de cierre: FSTRING_FIN. En triples comillas, una o dos comillas son texto
+     *  -> '{': abre un campo ('{' y se sigue con el análisis normal), '{{' es texto
+     *  -> '}' en una especificación: cierra su campo
+     *  -> Salto de línea (salvo en triples comillas) o fin de la entrada: f-string sin cerrar,
+     *     se cierra y el salto de línea se trata con el análisis normal (devuelve -1)
+    */
+    while(1){
 
-                break;
+        int especificacion = marco->tipo == MARCO_CAMPO;
 
+        if(c == marco->comilla){
+            if(texto) return textoFstring(tokenProcesado);
 
-            case 3:
+            if(marco->triple){
+                int seguidas = 1;
 
-                while(*charActual != '\"'){
-                    *charActual = siguienteCaracter(ficheroEntrada);
+                while(seguidas < 3 && (c = siguienteCaracter(ficheroEntrada)) == marco->comilla){
+                    seguidas++;
                 }
 
-                if(*charActual == '\"'){
-                    estado = 5;
+                if(seguidas < 3){
+                    texto = 1;
+                    continue;
                 }
+            }
 
-                else return 0;
-
-                break;
+            // Las comillas cierran también los campos que sigan abiertos
+            if(especificacion){
+                campoFstringSinCerrar();
 
-            case 4:
+                cerrarCamposFstring(lineas);
+            }
 
-                while(*charActual != '\''){
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+            return finFstring(tokenProcesado, lineas);
+        }
+        else if(c == '\\' && !especificacion){
+            c = saltarEscape(marco->comilla, 1, marco->crudo);
+            texto = 1;
+        }
+        else if(c == '{'){
+            if(texto) return textoFstring(tokenProcesado);
 
-                if(*charActual == '\''){
-                    estado = 5;
-                }
+            c = siguienteCaracter(ficheroEntrada);
 
-                else{
-                    return 0;
-                }
-
-                break;
+            if(c == '{' && !especificacion){
+                c = siguienteCaracter(ficheroEntrada);
+                texto = 1;
+                continue;
+            }
 
-            case 5:
+            // Sin sitio para otro marco el campo se deja dentro del texto
+            if(lineas->numMarcos == MAX_MARCOS_FSTRING){
+                saltarCampoFstring(&c, marco->comilla, marco->triple);
+                texto = 1;
+                continue;
+            }
 
-                tokenProcesado->lexema = devolverLexema();
-                return 1;
+            tokenProcesado->componente = LLAVE_IZQ;
+            tokenProcesado->lexema = (char *) lexemaComponente(LLAVE_IZQ);
 
+            lineas->nivelParentesis++;
+            lineas->marcos[lineas->numMarcos++] = (marcoFstring) {
+                .tipo = MARCO_CAMPO, .comilla = marco->comilla, .triple = marco->triple,
+                .crudo = marco->crudo, .nivelParentesis = lineas->nivelParentesis
+            };
 
+            return 1;
         }
-    }
-}
-
-int automataComentariosComillas(char *charActual){
-
-    int estado = 0;
-    char tipoComillas = ' '; //Guarda el tipo de comillas que se está leyendo para simplificar el automata
-
-    /**
-     * Ver automata en automatasPNG (ambos caminos del automata fueron colapsados en uno solo
-     * para simplificar el código, ya que ambos caminos son iguales)
-     *
-     * Estado 0: Inicial
-     * Estados 6: Final
-    */
-    while(1){
+        else if(c == '}' && especificacion){
+            if(texto) return textoFstring(tokenProcesado);
 
-        switch (estado){
+            tokenProcesado->componente = LLAVE_DER;
+            tokenProcesado->lexema = (char *) lexemaComponente(LLAVE_DER);
+            siguienteCaracter(ficheroEntrada);
 
-            case 0:
+            lineas->nivelParentesis = marco->nivelParentesis - 1;
+            lineas->numMarcos--;
 
-                if(*charActual == '\"'){
-                    tipoComillas = '\"';
-                    estado = 1;
-                    *charActual = siguienteCaracter(ficheroEntrada);
+            return 1;
+        }
+        else if(((c == '\n' || c == '\r') && !marco->triple) || c == EOF){
+            if(texto) return textoFstring(tokenProcesado);
 
-                } else if(*charActual == '\''){
-                    tipoComillas = '\'';
-                    estado = 1;
-                    *charActual = siguienteCaracter(ficheroEntrada);
+            stringSinCerrar();
 
-                } else return 0;
+            cerrarCamposFstring(lineas);
+            lineas->numMarcos--;
 
-                break;
+            return -1;
+        }
+        else {
+            char finLinea = marco->triple ? marco->comilla : '\n', retornoCarro = marco->triple ? marco->comilla : '\r';
 
-            case 1:
-                if(*charActual == tipoComillas){
-                    estado = 2;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                } else {
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
+            c = especificacion ? avanzarHasta(ficheroEntrada, marco->comilla, '{', '}', finLinea, retornoCarro)
+                               : avanzarHasta(ficheroEntrada, marco->comilla, '\\', '{', finLinea, retornoCarro);
+            texto = 1;
+        }
 
-                    return 0;
-                }
+        marco = &lineas->marcos[lineas->numMarcos - 1];
+    }
+}
 
-                break;
+// El delantero está en el caracter que sigue al texto, que no forma parte del lexema
+int textoFstring(token *tokenProcesado){
 
-            case 2:
-                if(*charActual == tipoComillas){
-                    estado = 3;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                } else {
-                    retrocederCaracter();
-                    *charActual = devolverDelantero();
+    retrocederCaracter();
 
-                    return 0;
-                }
+    tokenProcesado->componente = FSTRING_MEDIO;
+    tokenProcesado->lexema = devolverLexema();
 
-                break;
+    siguienteCaracter(ficheroEntrada);
 
-            case 3:
+    return 1;
+}
 
-                while(*charActual != tipoComillas){
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+// Los campos se cierran de dentro a fuera hasta el marco de texto, recuperando el nivel de paréntesis
+void cerrarCamposFstring(estadoLineas *lineas){
 
-                if(*charActual == tipoComillas){
-                    estado = 4;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                } else {
-                    return 0;
-                }
+    while(lineas->marcos[lineas->numMarcos - 1].tipo == MARCO_CAMPO){
+        lineas->nivelParentesis = lineas->marcos[--lineas->numMarcos].nivelParentesis - 1;
+    }
+}
 
-                break;
+// El lexema de FSTRING_FIN son las comillas de cierre, constantes
+int finFstring(token *tokenProcesado, estadoLineas *lineas){
 
-            case 4:
+    marcoFstring *marco = &lineas->marcos[--lineas->numMarcos];
 
-                if(*charActual == tipoComillas){
-                    estado = 5;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                } else {
-                    estado = 3;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
+    tokenProcesado->componente = FSTRING_FIN;
 
-                break;
+    if(marco->comilla == '\"') tokenProcesado->lexema = marco->triple ? "\"\"\"" : "\"";
+    else tokenProcesado->lexema = marco->triple ? "'''" : "'";
 
-            case 5:
+    siguienteCaracter(ficheroEntrada);
 
-                if(*charActual == tipoComillas){
-                    estado = 6;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                } else {
-                    estado = 3;
-                    *charActual = siguienteCaracter(ficheroEntrada);
-                }
-
-                break;
+    return 1;
+}
 
-            case 6:
-                return 1;
-        }
-    }
-}
\ No newline at end of file
+int puntoSincronizacion(int c){
+    return c == EOF || c == '\0' || ES_PARTE_ID(c) || (c >= 0xC2 && c <= 0xF4) || strchr(" \t\n\v\f\r", c) != NULL
+           || strchr("_#\"'()[]{},;.:=!+-*/%@&|^<>~", c) != NULL;
+}
@@ -6,6 +6,9 @@
  * Este archivo contiene las definiciones de las funciones del sistema del analizador léxico
  */
 
+#ifndef ANALIZADORLEXICO_H
+#define ANALIZADORLEXICO_H
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -15,11 +18,103 @@
 #include "../tablasHash/tablaHash.h"
 #include "../sistemaEntrada/sistemaEntrada.h"
 
+// Versión de los componentes que genera el analizador. Se incrementa cuando cambia el resultado del
+// análisis de alguna entrada: invalida los componentes guardados en las cachés en disco
+#define VERSION_ANALIZADOR 3
+
+// Niveles de sangría que se pueden abrir (el mismo límite que Python)
+#define MAX_SANGRIAS 100
+
+// F-strings y campos de sustitución anidados que se pueden separar, los más profundos se devuelven enteros
+#define MAX_MARCOS_FSTRING 16
+
+// Tipos de marco de la pila de f-strings
+#define MARCO_TEXTO 0 // Texto de un f-string
+#define MARCO_CAMPO 1 // Campo de sustitución entre llaves
+
+/**
+ * F-string o campo de sustitución abierto cuando se separan los f-strings. Los marcos de campo
+ * copian las comillas del f-string que los contiene, que también los cierran
+*/
+typedef struct marcoFstring {
+    int tipo;            // MARCO_TEXTO o MARCO_CAMPO
+    char comilla;        // Comilla del f-string
+    int triple;          // El f-string es de triples comillas
+    int crudo;           // El f-string tiene el prefijo r, las barras invertidas no forman secuencias
+    int finPendiente;    // Ya se ha devuelto el texto previo a las comillas de cierre, falta FSTRING_FIN
+    int nivelParentesis; // Nivel de paréntesis dentro del campo (cuenta su '{')
+    int especificacion;  // El campo está en su especificación de formato (tras ':')
+} marcoFstring;
+
+/**
+ * Estado de la estructura de líneas de un análisis: la pila de sangrías, los paréntesis abiertos
+ * (dentro de ellos las líneas se unen implícitamente), si la línea lógica actual tiene componentes y
+ * los f-strings abiertos. Un estado a cero es el del inicio de una entrada
+*/
+typedef struct estadoLineas {
+    int sangrias[MAX_SANGRIAS]; // Columnas de los niveles abiertos (el nivel 0 es implícito)
+    int numSangrias;
+    int dedentsPendientes;      // DEDENT que quedan por devolver
+    int nivelParentesis;        // Paréntesis, corchetes y llaves abiertos
+    int enLinea;                // La línea lógica actual ya tiene componentes
+    marcoFstring marcos[MAX_MARCOS_FSTRING]; // F-strings y campos abiertos, el último es el actual
+    int numMarcos;
+    int separarFstrings;        // Opción: separar los f-strings en sus partes (se conserva al reiniciar)
+} estadoLineas;
+
 /**
  * Función que devuelve el siguiente token (es decir el siguiente componente léxico)
  * @param t: puntero a una estructura token
  * @param tabla: tabla de símbolos en la que se buscará el siguiente componente léxico
- * @param fichero: fichero de entrada
- * @return Devuelve 1 si se ha procesado correctamente el token, 0 si ha habido un error
+ * @param fichero: fichero de entrada (el sistema de entrada ya sabe de dónde leer, puede ser NULL)
+ * @return Devuelve 1 si se ha procesado correctamente el token (y su lexema debe liberarse salvo que
+ *         sea constante, ver lexemaConstante; su posición es la de su primer caracter), 0 si ha
+ *         habido un error o se ha llegado al fin de fichero (componente EOF). Tras un error el caracter
+ *         erróneo se descarta, por lo que se puede seguir pidiendo componentes
 */
-int seguinte_comp_lexico(token *tokenProcesado, hashTable *tabla, FILE *fichero);
\ No newline at end of file
+int seguinte_comp_lexico(token *tokenProcesado, hashTable *tabla, FILE *fichero);
+/**
+ * Hace que los análisis del hilo actual usen el estado de líneas indicado
+ * @param estado: estado a usar, NULL para usar el estado propio del hilo
+*/
+void seleccionarEstadoLineas(estadoLineas *estado);
+
+/**
+ * Deja un estado de líneas como al inicio de una entrada
+ * @param estado: estado a reiniciar
+*/
+void reiniciarEstadoLineas(estadoLineas *estado);
+
+/**
+ * Activa o desactiva la separación de los f-strings. Desactivada (por defecto) un f-string es un
+ * único STRING; activada se devuelve FSTRING_INICIO, el texto como FSTRING_MEDIO, cada campo de
+ * sustitución como '{', los componentes de su expresión y '}', y FSTRING_FIN, como el tokenizador
+ * de Python 3.12
+ * @param estado: estado de líneas, NULL para el estado propio del hilo
+ * @param separar: 1 para separar los f-strings, 0 para devolverlos enteros
+*/
+void separarFstrings(estadoLineas *estado, int separar);
+
+/**
+ * Devuelve el lexema de un componente de ortografía fija (palabra reservada, operador o delimitador)
+ * @param componente: código del componente léxico (definiciones.h)
+ * @return cadena constante con el lexema, NULL si el componente no tiene un lexema fijo
+*/
+const char *lexemaComponente(int componente);
+
+/**
+ * Devuelve la clase de un operador o delimitador
+ * @param componente: código del componente léxico (definiciones.h)
+ * @return OP o DEL según la tabla SIGNOS_PUNTUACION, 0 si el componente no es un signo
+*/
+int claseSigno(int componente);
+
+/**
+ * Indica si el lexema de un componente léxico es una cadena constante (palabras reservadas,
+ * operadores, delimitadores, estructura de líneas y FSTRING_FIN) en lugar de una copia reservada con malloc
+ * @param t: componente léxico devuelto por seguinte_comp_lexico
+ * @return 1 si el lexema no se debe liberar, 0 si se debe liberar con free
+*/
+int lexemaConstante(const token *t);
+
+#endif // ANALIZADORLEXICO_H
@@ -0,0 +1,115 @@
+/**
+ * @file automataID.h
+ * @brief Autómata para el componente léxico ID, en sus dos variantes
+ *
+ * No es una cabecera normal: analizadorLexico.c la incluye dos veces, y cada vez
+ * genera una variante del autómata a partir del mismo código. Antes de incluirla
+ * se definen:
+ *  -> VARIANTE_ASCII: 1 para la variante de las entradas ASCII, que no trata los
+ *     caracteres multibyte, o 0 para la general, que además reconoce los caracteres
+ *     UTF-8 XID_Start y XID_Continue de los identificadores
+ *  -> NOMBRE_VARIANTE(nombre): nombre de las funciones de la variante
+ * Las dos variantes clasifican los caracteres ASCII con ES_INICIO_ID y ES_PARTE_ID,
+ * sin llamadas a ctype, que dependen del locale, y avanzan por las rachas de
+ * caracteres ASCII en bloque con avanzarIdentificador.
+ */
+
+// Devuelve el prefijo si lo leído es el prefijo de un string, NO_ES_ID si el caracter no empieza
+// un identificador y 0 en el resto de casos
+int NOMBRE_VARIANTE(automataID)(int *charActual, token *tokenProcesado){
+
+    size_t longitud = 0; // Caracteres leídos, los dos primeros se guardan por si son el prefijo de un string
+    char primeros[2] = { 0, 0 };
+
+    /**
+     * AUTÓMATA PARA EL COMPONENTE LÉXICO ID
+     *  -> Estado 0: Inicial
+     *  -> Estado 1: Lectura de caracteres
+     *  -> Estado 2: Aceptación (o inicio de un string si lo leído es un prefijo y sigue una comilla)
+    */
+    AUTOMATA(0){
+
+        ESTADO(0):
+
+            if(ES_INICIO_ID(*charActual)){
+                primeros[longitud++] = *charActual;
+
+                *charActual = siguienteCaracter(ficheroEntrada);
+                IR_A(1);
+            }
+
+#if !VARIANTE_ASCII
+            // Los caracteres multibyte no se guardan en primeros, así que nunca forman un prefijo
+            if(*charActual >= 0x80 && (longitud = leerCaracterID(charActual, 1)) > 0){
+                IR_A(1);
+            }
+#endif
+
+            return NO_ES_ID;
+
+        ESTADO(1):
+
+            if(ES_PARTE_ID(*charActual)){
+                if(longitud < 2){
+                    primeros[longitud++] = *charActual;
+
+                    *charActual = siguienteCaracter(ficheroEntrada);
+                    IR_A(1);
+                }
+
+                // A partir del tercer caracter ya no es un prefijo: la racha ASCII se avanza en bloque
+                *charActual = avanzarIdentificador(ficheroEntrada, &longitud);
+            }
+
+#if VARIANTE_ASCII
+            // Un caracter no ASCII solo llega aquí si el identificador sigue en un bloque cargado
+            // durante el autómata que no es ASCII: se vuelve a leer entero con la variante general.
+            // Si el lexema ya no cabe en el buffer su inicio se ha perdido y se acaba aquí
+            if(*charActual >= 0x80 && longitud < tamMaximoLexema()){
+                restaurarDelantero(desplazamientoInicioLexema());
+                *charActual = devolverDelantero();
+
+                return automataIDUtf8(charActual, tokenProcesado);
+            }
+#else
+            if(*charActual >= 0x80){
+                int bytes = leerCaracterID(charActual, 0);
+
+                if(bytes > 0){
+                    longitud += bytes;
+                    IR_A(1);
+                }
+            }
+#endif
+
+            IR_A(2);
+
+        ESTADO(2):
+
+            // El string empieza en el prefijo, se deja el delantero en la comilla
+            if((*charActual == '\"' || *charActual == '\'') && longitud <= 2){
+                int prefijo = prefijoString(primeros[0], primeros[1], (int) longitud);
+
+                if(prefijo != 0) return prefijo;
+            }
+
+            retrocederCaracter();
+
+            // Las palabras reservadas se reconocen sobre el buffer, sin copiar el lexema. Si el
+            // lexema está partido entre las dos mitades se copia y se busca en la tabla de símbolos
+            size_t longitudLexema;
+            const char *inicio = verLexema(&longitudLexema);
+
+            if(inicio != NULL && (tokenProcesado->componente = palabraReservada(inicio, longitudLexema)) != 0){
+                tokenProcesado->lexema = (char *) lexemaComponente(tokenProcesado->componente);
+                moverInicioLexemaADelantero();
+            } else {
+                tokenProcesado->componente = 0;
+                tokenProcesado->lexema = devolverLexema();
+            }
+
+            return 0;
+    }
+
+    return 0;
+}
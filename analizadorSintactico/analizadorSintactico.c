@@ -5,6 +5,9 @@
  * 
  * Este archivo contiene la implementación de las funciones del analizador sintáctico. 
  * Se encarga de pedir componentes léxicos al analizador léxico y de imprimirlos.
+ * Los miembros de un archivo zip se reparten entre varios hilos, cada uno con
+ * su doble buffer, tabla de símbolos, errores y estado de líneas, y se imprimen
+ * en el orden del archivo.
 */
 
 #include <stdio.h>
@@ -12,9 +15,34 @@
 #include "../analizadorLexico/analizadorLexico.h"
 #include "analizadorSintactico.h"
 #include "../sistemaEntrada/sistemaEntrada.h"
+#include "../gestionErrores/gestionErrores.h"
 
+#ifdef LECTURA_ASINCRONA
+#include <pthread.h>
 
-void imprimirComponenteLexico(token c);
+// Miembros de un archivo que analizan los hilos. La salida de cada miembro se guarda hasta que se
+// imprimen todos los anteriores
+typedef struct trabajoArchivo {
+    const archivoZip *archivo;
+    size_t tamBloque;
+    int separar;
+
+    pthread_mutex_t cerrojo;
+    pthread_cond_t terminado; // Se ha acabado un miembro
+    size_t siguiente; // Siguiente miembro sin asignar a un hilo
+    int *terminados; // Miembros ya analizados
+    char **salidas; // Salida de cada miembro, NULL si no se pudo guardar
+    size_t *longitudes;
+} trabajoArchivo;
+#endif
+
+// Funciones privadas
+void analizarEnFichero(hashTable *tabla, FILE *ficheroEntrada, FILE *salida);
+int analizarMiembro(const miembroZip *miembro, size_t tamBloque, int separar, FILE *salida);
+void imprimirComponenteLexico(token c, FILE *salida);
+#ifdef LECTURA_ASINCRONA
+void *hiloArchivo(void *contexto);
+#endif
 
 /**
  * @brief Función que inicia el análisis léxico, pidiendo componentes léxicos al analizador
@@ -22,27 +50,194 @@ void imprimirComponenteLexico(token c);
  * @param ficheroEntrada: fichero de entrada
  */
 void iniciarAnalisis(hashTable *tabla, FILE *ficheroEntrada) {
+    analizarEnFichero(tabla, ficheroEntrada, stdout);
+}
+
+// Analiza los miembros .py de un archivo con varios hilos, o de uno en uno con lectura síncrona
+int analizarArchivo(const archivoZip *archivo, int numHilos, size_t tamBloque, int separar) {
+
+#ifdef LECTURA_ASINCRONA
+    if(numHilos > 1 && archivo->numMiembros > 1){
+        trabajoArchivo trabajo = { .archivo = archivo, .tamBloque = tamBloque, .separar = separar };
+        pthread_t *hilos;
+
+        if((size_t) numHilos > archivo->numMiembros) numHilos = (int) archivo->numMiembros;
+
+        trabajo.salidas = (char **) calloc(archivo->numMiembros, sizeof(char *));
+        trabajo.longitudes = (size_t *) calloc(archivo->numMiembros, sizeof(size_t));
+        trabajo.terminados = (int *) calloc(archivo->numMiembros, sizeof(int));
+        hilos = (pthread_t *) malloc(numHilos * sizeof(pthread_t));
+
+        if(trabajo.salidas == NULL || trabajo.longitudes == NULL || trabajo.terminados == NULL || hilos == NULL){
+            free(trabajo.salidas);
+            free(trabajo.longitudes);
+            free(trabajo.terminados);
+            free(hilos);
+            fprintf(stderr, "ERROR analizadorSintactico.c: no se pudo reservar memoria para los hilos\n");
+            return 0;
+        }
+
+        pthread_mutex_init(&trabajo.cerrojo, NULL);
+        pthread_cond_init(&trabajo.terminado, NULL);
+
+        int creados = 0;
+
+        while(creados < numHilos && pthread_create(&hilos[creados], NULL, hiloArchivo, &trabajo) == 0) creados++;
+
+        // Sin ningún hilo los miembros se analizan en este
+        if(creados == 0) hiloArchivo(&trabajo);
+
+        int correcto = 1;
+
+        for(size_t i = 0; i < archivo->numMiembros; i++){
+            pthread_mutex_lock(&trabajo.cerrojo);
+
+            while(!trabajo.terminados[i]) pthread_cond_wait(&trabajo.terminado, &trabajo.cerrojo);
+
+            pthread_mutex_unlock(&trabajo.cerrojo);
+
+            if(trabajo.salidas[i] != NULL) fwrite(trabajo.salidas[i], 1, trabajo.longitudes[i], stdout);
+            else correcto = 0;
+
+            free(trabajo.salidas[i]);
+        }
+
+        for(int i = 0; i < creados; i++) pthread_join(hilos[i], NULL);
+
+        pthread_cond_destroy(&trabajo.terminado);
+        pthread_mutex_destroy(&trabajo.cerrojo);
+        free(trabajo.salidas);
+        free(trabajo.longitudes);
+        free(trabajo.terminados);
+        free(hilos);
+
+        return correcto;
+    }
+#else
+    (void) numHilos;
+#endif
+
+    int correcto = 1;
+
+    for(size_t i = 0; i < archivo->numMiembros; i++){
+        correcto &= analizarMiembro(&archivo->miembros[i], tamBloque, separar, stdout);
+    }
+
+    return correcto;
+}
+
+//------------------------------------------ FUNCIONES PRIVADAS --------------------------------------------------
+
+// Pide componentes léxicos al analizador hasta el fin de fichero y los imprime en la salida
+void analizarEnFichero(hashTable *tabla, FILE *ficheroEntrada, FILE *salida) {
     token t;
 
-    printf("%-33s %-10s\n", "Lexema", "ID");
-    printf("--------------------------------- ----------\n");
+    fprintf(salida, "%-33s %-10s %s\n", "Lexema", "ID", "Posición");
+    fprintf(salida, "--------------------------------- ---------- ----------\n");
 
     do { //Pedimos componentes lexicos al analizadorLexico hasta que reciba EOF.
-        printf("--------------------------------- ----------\n");
+        fprintf(salida, "--------------------------------- ---------- ----------\n");
 
         int liberarMemoria = seguinte_comp_lexico(&t, tabla, ficheroEntrada);
         //Si ha habido algún error, o es el fin de fichero no se imprime el componente.
-        if (t.componente != EOF) {
-            imprimirComponenteLexico(t);
+        if (liberarMemoria) {
+            imprimirComponenteLexico(t, salida);
+            if (!lexemaConstante(&t)) free(t.lexema);
         }
 
-        if(liberarMemoria) free(t.lexema);
-
     } while (t.componente != EOF);
+
+    fprintf(salida, "Fin de fichero\n");
+
+    // Los errores se han ido guardando durante el análisis sin detenerlo
+    imprimirErrores(salida);
 }
 
-// Imprime el componente léxico en la consola
-void imprimirComponenteLexico(token t) {
+// Analiza un miembro de un archivo con su propio doble buffer, tabla de símbolos, errores y estado de
+// líneas, e imprime sus componentes tras una cabecera con su ruta
+int analizarMiembro(const miembroZip *miembro, size_t tamBloque, int separar, FILE *salida) {
+
+    dobleBuffering *entrada = crearDobleCentinelaMiembro(miembro, tamBloque);
+    hashTable tabla;
+    registroErrores errores = { .numErrores = 0 };
+    estadoLineas lineas;
+
+    if(entrada == NULL || !inicializarTabla(&tabla)){
+        destruirDobleCentinela(entrada);
+        fprintf(stderr, "ERROR analizadorSintactico.c: no se pudo analizar %s\n", miembro->ruta);
+        return 0;
+    }
+
+    fprintf(salida, "==> %s <==\n", miembro->ruta);
+
+    reiniciarEstadoLineas(&lineas);
+    separarFstrings(&lineas, separar);
+
+    seleccionarDobleCentinela(entrada);
+    seleccionarRegistroErrores(&errores);
+    seleccionarEstadoLineas(&lineas);
+
+    analizarEnFichero(&tabla, NULL, salida);
+
+    seleccionarDobleCentinela(NULL);
+    seleccionarRegistroErrores(NULL);
+    seleccionarEstadoLineas(NULL);
+
+    destruirTabla(tabla);
+    destruirDobleCentinela(entrada);
+
+    fprintf(salida, "\n");
+
+    return 1;
+}
+
+// Imprime el componente léxico en la salida
+void imprimirComponenteLexico(token t, FILE *salida) {
     // Imprime los valores en el mismo ancho de columna que las cabeceras
-    printf("%-33s %-10d\n", t.lexema, t.componente);
-}
\ No newline at end of file
+    fprintf(salida, "%-33s %-10d %d:%d\n", t.lexema, t.componente, t.posicion.linea, t.posicion.columna);
+}
+
+#ifdef LECTURA_ASINCRONA
+// Hilo que analiza miembros del archivo hasta que no queda ninguno. Cada miembro se imprime en memoria
+void *hiloArchivo(void *contexto) {
+
+    trabajoArchivo *trabajo = (trabajoArchivo *) contexto;
+
+    for(;;){
+        pthread_mutex_lock(&trabajo->cerrojo);
+        size_t i = trabajo->siguiente;
+
+        if(i < trabajo->archivo->numMiembros) trabajo->siguiente++;
+
+        pthread_mutex_unlock(&trabajo->cerrojo);
+
+        if(i >= trabajo->archivo->numMiembros) return NULL;
+
+        char *texto = NULL;
+        size_t longitud = 0;
+        FILE *salida = open_memstream(&texto, &longitud);
+
+        int correcto = 0;
+
+        if(salida != NULL){
+            correcto = analizarMiembro(&trabajo->archivo->miembros[i], trabajo->tamBloque, trabajo->separar, salida);
+            fclose(salida);
+        }
+        else fprintf(stderr, "ERROR analizadorSintactico.c: no se pudo reservar memoria para la salida de %s\n",
+                     trabajo->archivo->miembros[i].ruta);
+
+        // Un miembro que no se ha podido analizar se omite, pero se marca como acabado
+        if(!correcto){
+            free(texto);
+            texto = NULL;
+        }
+
+        pthread_mutex_lock(&trabajo->cerrojo);
+        trabajo->terminados[i] = 1;
+        trabajo->salidas[i] = texto;
+        trabajo->longitudes[i] = longitud;
+        pthread_cond_broadcast(&trabajo->terminado);
+        pthread_mutex_unlock(&trabajo->cerrojo);
+    }
+}
+#endif
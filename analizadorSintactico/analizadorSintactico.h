@@ -14,6 +14,7 @@
 #include "../analizadorLexico/analizadorLexico.h"
 #include "analizadorSintactico.h"
 #include "../sistemaEntrada/sistemaEntrada.h"
+#include "../archivoZip/archivoZip.h"
 
 /**
  * Función que inicia el análisis léxico, pidiendo componentes léxicos al analizador
@@ -22,4 +23,15 @@
  */
 void iniciarAnalisis(hashTable *tabla, FILE *ficheroEntrada);
 
+/**
+ * Analiza los miembros .py de un archivo zip y los imprime en el orden del archivo, cada uno tras una
+ * cabecera con su ruta. Con lectura asíncrona los miembros se reparten entre varios hilos
+ * @param archivo: archivo abierto
+ * @param numHilos: número máximo de hilos que analizan miembros a la vez
+ * @param tamBloque: tamaño de cada mitad del buffer de los miembros comprimidos, 0 para usar BUFF_SIZE
+ * @param separar: 1 para separar los f-strings en sus partes
+ * @return 1 si se han analizado todos los miembros, 0 si alguno no se pudo analizar
+ */
+int analizarArchivo(const archivoZip *archivo, int numHilos, size_t tamBloque, int separar);
+
 #endif // ANALIZADORSINTACTICO_H
\ No newline at end of file
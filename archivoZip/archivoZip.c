@@ -0,0 +1,259 @@
+/**
+ * @file archivoZip.c
+ * @date 19/10/2026
+ * @brief Lectura de los ficheros Python de un archivo zip o wheel
+ *
+ * Solo se usa el directorio central: el final del archivo (EOCD) indica dónde
+ * empieza y cada una de sus entradas da el método, los tamaños y la cabecera
+ * local del miembro, tras la que están sus datos. Todos los desplazamientos
+ * se comprueban contra el tamaño del archivo antes de usarlos.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "archivoZip.h"
+
+// Firmas y tamaños fijos de las estructuras del formato
+#define FIRMA_FIN_DIRECTORIO 0x06054b50
+#define FIRMA_DIRECTORIO 0x02014b50
+#define FIRMA_CABECERA_LOCAL 0x04034b50
+#define TAM_FIN_DIRECTORIO 22
+#define TAM_DIRECTORIO 46
+#define TAM_CABECERA_LOCAL 30
+#define MAX_COMENTARIO 65535
+
+// Bit de los indicadores de un miembro cifrado
+#define INDICADOR_CIFRADO 0x0001
+
+// Funciones privadas
+uint16_t leer16(const unsigned char *p);
+uint32_t leer32(const unsigned char *p);
+const unsigned char *buscarFinDirectorio(const unsigned char *mapa, size_t tamano);
+int leerDirectorio(archivoZip *archivo, const char *nombre);
+int anadirMiembro(archivoZip *archivo, size_t *capacidad, const miembroZip *miembro);
+int esFicheroPython(const char *ruta, size_t longitud);
+
+// Proyecta el archivo y lee su directorio central
+int abrirArchivoZip(archivoZip *archivo, const char *nombre){
+
+    memset(archivo, 0, sizeof(archivoZip));
+
+    int descriptor = open(nombre, O_RDONLY);
+
+    if(descriptor < 0){
+        fprintf(stderr, "ERROR archivoZip.c: no se pudo abrir %s\n", nombre);
+        return 0;
+    }
+
+    struct stat datos;
+
+    if(fstat(descriptor, &datos) < 0 || !S_ISREG(datos.st_mode) || datos.st_size < TAM_FIN_DIRECTORIO){
+        fprintf(stderr, "ERROR archivoZip.c: %s no es un archivo zip\n", nombre);
+        close(descriptor);
+        return 0;
+    }
+
+    archivo->tamano = (size_t) datos.st_size;
+    void *mapa = mmap(NULL, archivo->tamano, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+    // La proyección se mantiene aunque se cierre el descriptor
+    close(descriptor);
+
+    if(mapa == MAP_FAILED){
+        fprintf(stderr, "ERROR archivoZip.c: no se pudo proyectar %s en memoria\n", nombre);
+        return 0;
+    }
+
+    archivo->mapa = (const char *) mapa;
+
+    if(!leerDirectorio(archivo, nombre)){
+        cerrarArchivoZip(archivo);
+        return 0;
+    }
+
+    return 1;
+}
+
+// Los miembros sin comprimir se leen sobre la proyección y los comprimidos se descomprimen al leerlos
+dobleBuffering *crearDobleCentinelaMiembro(const miembroZip *miembro, size_t tamBloque){
+
+    if(miembro->metodo == ZIP_STORED) return crearDobleCentinelaMemoria(miembro->datos, miembro->longitud);
+
+    return crearDobleCentinelaDeflate(miembro->datos, miembro->longitudComprimida, tamBloque);
+}
+
+// Libera los miembros y deshace la proyección
+void cerrarArchivoZip(archivoZip *archivo){
+
+    for(size_t i = 0; i < archivo->numMiembros; i++){
+        free(archivo->miembros[i].ruta);
+    }
+
+    free(archivo->miembros);
+
+    if(archivo->mapa != NULL) munmap((void *) archivo->mapa, archivo->tamano);
+
+    memset(archivo, 0, sizeof(archivoZip));
+}
+
+//------------------------------------------ FUNCIONES PRIVADAS --------------------------------------------------
+
+// Los enteros del formato zip están en little endian
+uint16_t leer16(const unsigned char *p){
+    return (uint16_t) (p[0] | p[1] << 8);
+}
+
+uint32_t leer32(const unsigned char *p){
+    return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+// Busca el final del directorio central desde el final del archivo. Solo lo puede seguir el comentario
+// del archivo, de hasta MAX_COMENTARIO bytes
+const unsigned char *buscarFinDirectorio(const unsigned char *mapa, size_t tamano){
+
+    size_t limite = tamano - TAM_FIN_DIRECTORIO > MAX_COMENTARIO ? tamano - TAM_FIN_DIRECTORIO - MAX_COMENTARIO : 0;
+
+    for(size_t i = tamano - TAM_FIN_DIRECTORIO + 1; i-- > limite; ){
+        if(leer32(mapa + i) == FIRMA_FIN_DIRECTORIO && i + TAM_FIN_DIRECTORIO + leer16(mapa + i + 20) <= tamano){
+            return mapa + i;
+        }
+    }
+
+    return NULL;
+}
+
+// Recorre el directorio central y guarda los miembros .py que se pueden leer
+int leerDirectorio(archivoZip *archivo, const char *nombre){
+
+    const unsigned char *mapa = (const unsigned char *) archivo->mapa;
+    const unsigned char *fin = buscarFinDirectorio(mapa, archivo->tamano);
+
+    if(fin == NULL){
+        fprintf(stderr, "ERROR archivoZip.c: %s no es un archivo zip\n", nombre);
+        return 0;
+    }
+
+    size_t numEntradas = leer16(fin + 10);
+    size_t tamDirectorio = leer32(fin + 12);
+    size_t inicioDirectorio = leer32(fin + 16);
+
+    // ZIP64 guarda los valores reales en otra estructura y marca los de aquí como saturados
+    if(numEntradas == 0xFFFF || tamDirectorio == 0xFFFFFFFF || inicioDirectorio == 0xFFFFFFFF){
+        fprintf(stderr, "ERROR archivoZip.c: %s es un archivo ZIP64, no admitido\n", nombre);
+        return 0;
+    }
+
+    if(leer16(fin + 4) != 0 || leer16(fin + 6) != 0){
+        fprintf(stderr, "ERROR archivoZip.c: %s ocupa varios volúmenes, no admitido\n", nombre);
+        return 0;
+    }
+
+    if(inicioDirectorio > (size_t) (fin - mapa) || tamDirectorio > (size_t) (fin - mapa) - inicioDirectorio){
+        fprintf(stderr, "ERROR archivoZip.c: el directorio central de %s está dañado\n", nombre);
+        return 0;
+    }
+
+    // Los desplazamientos son relativos al inicio del zip, que puede tener datos delante (por ejemplo
+    // un ejecutable autoextraíble): el directorio acaba justo donde empieza su final
+    size_t desfase = (size_t) (fin - mapa) - tamDirectorio - inicioDirectorio;
+
+    inicioDirectorio += desfase;
+
+    size_t capacidad = 0;
+    size_t posicion = inicioDirectorio;
+    size_t finDirectorio = inicioDirectorio + tamDirectorio;
+
+    for(size_t i = 0; i < numEntradas; i++){
+
+        if(finDirectorio - posicion < TAM_DIRECTORIO || leer32(mapa + posicion) != FIRMA_DIRECTORIO){
+            fprintf(stderr, "ERROR archivoZip.c: el directorio central de %s está dañado\n", nombre);
+            return 0;
+        }
+
+        const unsigned char *entrada = mapa + posicion;
+        size_t longitudRuta = leer16(entrada + 28);
+        size_t longitudEntrada = TAM_DIRECTORIO + longitudRuta + leer16(entrada + 30) + leer16(entrada + 32);
+
+        if(finDirectorio - posicion < longitudEntrada){
+            fprintf(stderr, "ERROR archivoZip.c: el directorio central de %s está dañado\n", nombre);
+            return 0;
+        }
+
+        posicion += longitudEntrada;
+
+        const char *ruta = (const char *) entrada + TAM_DIRECTORIO;
+
+        if(!esFicheroPython(ruta, longitudRuta)) continue;
+
+        miembroZip miembro;
+        miembro.metodo = leer16(entrada + 10);
+        miembro.longitudComprimida = leer32(entrada + 20);
+        miembro.longitud = leer32(entrada + 24);
+
+        size_t cabecera = leer32(entrada + 42) + desfase;
+
+        if(leer16(entrada + 8) & INDICADOR_CIFRADO){
+            fprintf(stderr, "ERROR archivoZip.c: %.*s está cifrado, se omite\n", (int) longitudRuta, ruta);
+            continue;
+        }
+
+        if(miembro.metodo != ZIP_STORED && miembro.metodo != ZIP_DEFLATE){
+            fprintf(stderr, "ERROR archivoZip.c: %.*s usa un método de compresión no admitido (%d), se omite\n",
+                    (int) longitudRuta, ruta, miembro.metodo);
+            continue;
+        }
+
+        // Los datos empiezan tras la cabecera local, cuyos campos variables pueden no coincidir con los del directorio
+        if(cabecera > archivo->tamano - TAM_CABECERA_LOCAL || leer32(mapa + cabecera) != FIRMA_CABECERA_LOCAL){
+            fprintf(stderr, "ERROR archivoZip.c: la cabecera de %.*s está dañada, se omite\n", (int) longitudRuta, ruta);
+            continue;
+        }
+
+        size_t inicioDatos = cabecera + TAM_CABECERA_LOCAL + leer16(mapa + cabecera + 26) + leer16(mapa + cabecera + 28);
+
+        if(inicioDatos > archivo->tamano || miembro.longitudComprimida > archivo->tamano - inicioDatos ||
+           (miembro.metodo == ZIP_STORED && miembro.longitud != miembro.longitudComprimida)){
+            fprintf(stderr, "ERROR archivoZip.c: los datos de %.*s están dañados, se omite\n", (int) longitudRuta, ruta);
+            continue;
+        }
+
+        miembro.datos = archivo->mapa + inicioDatos;
+
+        if((miembro.ruta = strndup(ruta, longitudRuta)) == NULL || !anadirMiembro(archivo, &capacidad, &miembro)){
+            free(miembro.ruta);
+            fprintf(stderr, "ERROR archivoZip.c: no se pudo reservar memoria para los miembros\n");
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Añade un miembro al archivo, ampliando el array si hace falta
+int anadirMiembro(archivoZip *archivo, size_t *capacidad, const miembroZip *miembro){
+
+    if(archivo->numMiembros == *capacidad){
+        size_t nuevaCapacidad = *capacidad ? *capacidad * 2 : 16;
+        miembroZip *miembros = (miembroZip *) realloc(archivo->miembros, nuevaCapacidad * sizeof(miembroZip));
+
+        if(miembros == NULL) return 0;
+
+        archivo->miembros = miembros;
+        *capacidad = nuevaCapacidad;
+    }
+
+    archivo->miembros[archivo->numMiembros++] = *miembro;
+
+    return 1;
+}
+
+// Un miembro se analiza si su ruta acaba en .py
+int esFicheroPython(const char *ruta, size_t longitud){
+    return longitud > 3 && memcmp(ruta + longitud - 3, ".py", 3) == 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file archivoZip.h
+ * @date 19/10/2026
+ * @brief Lectura de los ficheros Python de un archivo zip o wheel
+ *
+ * El archivo se proyecta en memoria y se recorre su directorio central, sin
+ * extraer nada. Cada miembro .py se lee con un doble buffer propio: los
+ * miembros sin comprimir (stored) se analizan directamente sobre la proyección
+ * y los comprimidos con deflate se descomprimen según se leen. No se admiten
+ * archivos ZIP64 ni miembros cifrados.
+ */
+
+#ifndef ARCHIVOZIP_H
+#define ARCHIVOZIP_H
+
+#include <stddef.h>
+#include "../sistemaEntrada/sistemaEntrada.h"
+
+// Métodos de compresión admitidos
+#define ZIP_STORED 0
+#define ZIP_DEFLATE 8
+
+// Miembro .py de un archivo zip
+typedef struct miembroZip {
+    char *ruta; // Ruta del miembro dentro del archivo
+    const char *datos; // Datos del miembro en la proyección del archivo
+    size_t longitudComprimida;
+    size_t longitud; // Longitud sin comprimir
+    int metodo; // ZIP_STORED o ZIP_DEFLATE
+} miembroZip;
+
+// Archivo zip proyectado en memoria
+typedef struct archivoZip {
+    const char *mapa; // Proyección del archivo, NULL si está vacío
+    size_t tamano;
+    miembroZip *miembros; // Miembros .py en el orden del directorio central
+    size_t numMiembros;
+} archivoZip;
+
+/**
+ * Abre un archivo zip y busca sus miembros .py. Los miembros que no se pueden leer (cifrados o con
+ * otro método de compresión) se saltan con un aviso
+ * @param archivo: archivo a inicializar
+ * @param nombre: ruta del archivo
+ * @return 1 si se ha abierto, 0 si no existe o no es un archivo zip válido
+ */
+int abrirArchivoZip(archivoZip *archivo, const char *nombre);
+
+/**
+ * Crea un doble buffer que lee un miembro del archivo
+ * @param miembro: miembro a leer, el archivo debe seguir abierto mientras exista el doble buffer
+ * @param tamBloque: tamaño de cada mitad del buffer de los miembros comprimidos, 0 para usar BUFF_SIZE
+ * @return el doble buffer creado, NULL si no se pudo crear
+ */
+dobleBuffering *crearDobleCentinelaMiembro(const miembroZip *miembro, size_t tamBloque);
+
+/**
+ * Cierra un archivo zip y libera sus miembros
+ * @param archivo: archivo a cerrar
+ */
+void cerrarArchivoZip(archivoZip *archivo);
+
+#endif
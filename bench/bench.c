@@ -0,0 +1,369 @@
+/**
+ * @file bench.c
+ * @date 19/10/2026
+ * @brief Pruebas de rendimiento del analizador léxico
+ *
+ * Mide cada fase del analizador sobre los ficheros indicados y muestra el
+ * mejor tiempo de varias repeticiones:
+ *  -> entrada: solo el sistema de entrada (leer todos los caracteres)
+ *  -> lexico: sistema de entrada, autómatas y tabla de símbolos, como el
+ *     ejecutable pero sin imprimir los componentes
+ *  -> memoria: la biblioteca (pylex) sobre el fichero ya cargado en memoria
+ *  -> columnas: la biblioteca sobre el fichero en memoria guardando los
+ *     componentes en un pylexBufferTokens, y un recorrido que cuenta los ID
+ *  -> empaque: la biblioteca sobre el fichero en memoria guardando los
+ *     componentes empaquetados en 8 bytes (pylexFlujoEmpaquetado)
+ *
+ * Para contar las reservas de memoria se enlaza con -Wl,--wrap de malloc,
+ * calloc, realloc y strdup (ver el makefile), de modo que solo se cuentan las
+ * del analizador y no las internas de la biblioteca de C.
+ *
+ * En Linux también se cuentan los fallos de predicción de saltos con
+ * perf_event_open (si el sistema no lo permite la columna sale con '-'). Para
+ * comparar el despacho de los autómatas se compila con make DESPACHO=switch.
+ *
+ * Uso: bench [-r repeticiones] [-b tam_bloque] fichero...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdint.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "../analizadorLexico/analizadorLexico.h"
+#include "../sistemaEntrada/sistemaEntrada.h"
+#include "../gestionErrores/gestionErrores.h"
+#include "../pylex/pylex.h"
+
+#define TAM_LOTE 256 // Componentes que se piden en cada llamada a pylex_siguienteLote
+
+// Resultado de una fase
+typedef struct medida {
+    double segundos; // Mejor tiempo de las repeticiones
+    size_t tokens; // Componentes léxicos reconocidos
+    size_t reservas; // Reservas de memoria en una repetición
+    int64_t fallosSalto; // Fallos de predicción de saltos en la mejor repetición, -1 si no se pueden contar
+} medida;
+
+// Función que ejecuta una fase sobre un fichero y devuelve el número de componentes
+typedef size_t (*funcionFase)(const char *nombreFichero, const char *datos, size_t longitud);
+
+static size_t numReservas = 0; // Reservas hechas por el analizador (el hilo lector no reserva memoria)
+static size_t tamBloque = 0; // 0 para usar el tamaño por defecto del sistema de entrada
+size_t numIdentificadores = 0; // Resultado del recorrido de la fase columnas (global para que no se elimine)
+static int contadorSaltos = -1; // Descriptor del contador de fallos de predicción, -1 si no hay
+
+//------------------------------------------ CONTEO DE RESERVAS --------------------------------------------------
+
+void *__real_malloc(size_t tamano);
+void *__real_calloc(size_t numero, size_t tamano);
+void *__real_realloc(void *puntero, size_t tamano);
+char *__real_strdup(const char *cadena);
+
+void *__wrap_malloc(size_t tamano){
+    numReservas++;
+    return __real_malloc(tamano);
+}
+
+void *__wrap_calloc(size_t numero, size_t tamano){
+    numReservas++;
+    return __real_calloc(numero, tamano);
+}
+
+void *__wrap_realloc(void *puntero, size_t tamano){
+    numReservas++;
+    return __real_realloc(puntero, tamano);
+}
+
+char *__wrap_strdup(const char *cadena){
+    numReservas++;
+    return __real_strdup(cadena);
+}
+
+//------------------------------------------ FASES --------------------------------------------------
+
+// Solo el sistema de entrada: se leen todos los caracteres del fichero
+size_t faseEntrada(const char *nombreFichero, const char *datos, size_t longitud){
+
+    FILE *fichero = fopen(nombreFichero, "r");
+
+    if(fichero == NULL || !inicializarDobleCentinela(fichero, tamBloque)) exit(EXIT_FAILURE);
+
+    int c = devolverDelantero();
+
+    while(c != EOF){
+        // Se avanza el inicio del lexema de vez en cuando para que el hilo lector pueda seguir
+        if(c == '\n') moverInicioLexemaADelantero();
+        c = siguienteCaracter(fichero);
+    }
+
+    finalizarDobleCentinela();
+    fclose(fichero);
+
+    return 0;
+}
+
+// El análisis léxico completo leyendo del fichero, como el ejecutable pero sin imprimir
+size_t faseLexico(const char *nombreFichero, const char *datos, size_t longitud){
+
+    FILE *fichero = fopen(nombreFichero, "r");
+    hashTable tabla;
+    registroErrores errores;
+    token t;
+    size_t tokens = 0;
+
+    if(fichero == NULL || !inicializarDobleCentinela(fichero, tamBloque) || !inicializarTabla(&tabla)) exit(EXIT_FAILURE);
+
+    vaciarRegistroErrores(&errores);
+    seleccionarRegistroErrores(&errores);
+
+    do {
+        if(seguinte_comp_lexico(&t, &tabla, fichero)){
+            if(!lexemaConstante(&t)) free(t.lexema);
+            tokens++;
+        }
+    } while(t.componente != EOF);
+
+    seleccionarRegistroErrores(NULL);
+    destruirTabla(tabla);
+    finalizarDobleCentinela();
+    fclose(fichero);
+
+    return tokens;
+}
+
+// La biblioteca sobre el fichero ya cargado en memoria
+size_t faseMemoria(const char *nombreFichero, const char *datos, size_t longitud){
+
+    pylex *lexer = pylex_crear();
+    pylexToken lote[TAM_LOTE];
+    size_t tokens = 0, n;
+
+    if(lexer == NULL || !pylex_desdeBuffer(lexer, datos, longitud)) exit(EXIT_FAILURE);
+
+    while( (n = pylex_siguienteLote(lexer, lote, TAM_LOTE)) > 0 ){
+        tokens += n;
+    }
+
+    pylex_destruir(lexer);
+
+    return tokens;
+}
+
+// La biblioteca guardando los componentes como arrays paralelos y contando después los identificadores
+size_t faseColumnas(const char *nombreFichero, const char *datos, size_t longitud){
+
+    pylex *lexer = pylex_crear();
+    pylexBufferTokens buffer = { 0 };
+
+    if(lexer == NULL || !pylex_desdeBuffer(lexer, datos, longitud)) exit(EXIT_FAILURE);
+
+    while(pylex_analizarEnBuffer(lexer, &buffer, 0) > 0);
+
+    // Solo se lee el array de componentes
+    numIdentificadores = 0;
+    for(size_t i = 0; i < buffer.numero; i++) numIdentificadores += buffer.componentes[i] == ID;
+
+    size_t tokens = buffer.numero;
+
+    pylex_liberarBufferTokens(&buffer);
+    pylex_destruir(lexer);
+
+    return tokens;
+}
+
+// La biblioteca guardando los componentes empaquetados en 8 bytes
+size_t faseEmpaquetado(const char *nombreFichero, const char *datos, size_t longitud){
+
+    pylex *lexer = pylex_crear();
+    pylexFlujoEmpaquetado flujo = { 0 };
+
+    if(lexer == NULL || !pylex_desdeBuffer(lexer, datos, longitud)) exit(EXIT_FAILURE);
+
+    while(pylex_analizarEmpaquetado(lexer, &flujo, 0) > 0);
+
+    size_t tokens = flujo.componentes;
+
+    pylex_liberarFlujoEmpaquetado(&flujo);
+    pylex_destruir(lexer);
+
+    return tokens;
+}
+
+//------------------------------------------ FUNCIONES PRIVADAS --------------------------------------------------
+
+// Segundos desde un instante fijo
+double ahora(){
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+// Abre el contador de fallos de predicción de saltos del proceso (solo en espacio de usuario)
+void abrirContadorSaltos(){
+#ifdef __linux__
+    struct perf_event_attr atributos;
+
+    memset(&atributos, 0, sizeof(atributos));
+    atributos.type = PERF_TYPE_HARDWARE;
+    atributos.size = sizeof(atributos);
+    atributos.config = PERF_COUNT_HW_BRANCH_MISSES;
+    atributos.disabled = 1;
+    atributos.exclude_kernel = 1;
+    atributos.exclude_hv = 1;
+    atributos.inherit = 1; // También el hilo lector
+
+    contadorSaltos = (int) syscall(SYS_perf_event_open, &atributos, 0, -1, -1, 0);
+#endif
+}
+
+// Pone a cero y arranca el contador de fallos de predicción
+void iniciarContadorSaltos(){
+#ifdef __linux__
+    if(contadorSaltos < 0) return;
+
+    ioctl(contadorSaltos, PERF_EVENT_IOC_RESET, 0);
+    ioctl(contadorSaltos, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+// Para el contador y devuelve los fallos de predicción contados, -1 si no hay contador
+int64_t leerContadorSaltos(){
+#ifdef __linux__
+    uint64_t fallos;
+
+    if(contadorSaltos < 0) return -1;
+
+    ioctl(contadorSaltos, PERF_EVENT_IOC_DISABLE, 0);
+
+    if(read(contadorSaltos, &fallos, sizeof(fallos)) == sizeof(fallos)) return (int64_t) fallos;
+#endif
+    return -1;
+}
+
+// Ejecuta una fase varias veces y se queda con el mejor tiempo
+medida medirFase(funcionFase fase, int repeticiones, const char *nombreFichero, const char *datos, size_t longitud){
+
+    medida m = { .segundos = -1 };
+
+    for(int i = 0; i < repeticiones; i++){
+        numReservas = 0;
+
+        iniciarContadorSaltos();
+        double inicio = ahora();
+        m.tokens = fase(nombreFichero, datos, longitud);
+        double segundos = ahora() - inicio;
+        int64_t fallosSalto = leerContadorSaltos();
+
+        m.reservas = numReservas;
+        if(m.segundos < 0 || segundos < m.segundos){
+            m.segundos = segundos;
+            m.fallosSalto = fallosSalto;
+        }
+    }
+
+    return m;
+}
+
+// Imprime una fila de resultados
+void imprimirMedida(const char *nombreFichero, const char *nombreFase, medida m, size_t longitud){
+
+    printf("%-32s %-8s %10.1f", nombreFichero, nombreFase, longitud / m.segundos / (1 << 20));
+
+    if(m.tokens > 0){
+        printf(" %12.2f %12.3f", m.tokens / m.segundos / 1e6, (double) m.reservas / m.tokens);
+    } else {
+        printf(" %12s %12s", "-", "-");
+    }
+
+    // Los fallos de predicción se dan por KB para poder comparar también la fase de entrada
+    if(m.fallosSalto >= 0 && longitud > 0){
+        printf(" %12.2f\n", m.fallosSalto / (longitud / 1024.0));
+    } else {
+        printf(" %12s\n", "-");
+    }
+}
+
+// Carga el fichero entero en memoria
+char *cargarFichero(const char *nombreFichero, size_t *longitud){
+
+    FILE *fichero = fopen(nombreFichero, "rb");
+    char *datos;
+
+    if(fichero == NULL){
+        ficheroNoEncontrado((char *) nombreFichero);
+        return NULL;
+    }
+
+    fseek(fichero, 0, SEEK_END);
+    *longitud = ftell(fichero);
+    rewind(fichero);
+
+    if( (datos = (char *) malloc(*longitud + 1)) == NULL || fread(datos, 1, *longitud, fichero) != *longitud ){
+        free(datos);
+        fclose(fichero);
+        return NULL;
+    }
+
+    fclose(fichero);
+
+    return datos;
+}
+
+int main(int argc, char *argv[]){
+
+    int repeticiones = 5;
+    int primerFichero = 1;
+
+    while(primerFichero < argc - 1 && argv[primerFichero][0] == '-'){
+        if(strcmp(argv[primerFichero], "-r") == 0) repeticiones = atoi(argv[primerFichero + 1]);
+        else if(strcmp(argv[primerFichero], "-b") == 0) tamBloque = strtoul(argv[primerFichero + 1], NULL, 10);
+        else break;
+
+        primerFichero += 2;
+    }
+
+    if(primerFichero >= argc || repeticiones < 1){
+        fprintf(stderr, "Uso: %s [-r repeticiones] [-b tam_bloque] fichero...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+#ifdef LECTURA_ASINCRONA
+    printf("Lectura asíncrona, bloque de %zu bytes, mejor de %d repeticiones\n\n", tamBloque > 0 ? tamBloque : BUFF_SIZE, repeticiones);
+#else
+    printf("Lectura síncrona, bloque de %zu bytes, mejor de %d repeticiones\n\n", tamBloque > 0 ? tamBloque : BUFF_SIZE, repeticiones);
+#endif
+
+    abrirContadorSaltos();
+
+    printf("%-32s %-8s %10s %12s %12s %12s\n", "Fichero", "Fase", "MB/s", "Mtokens/s", "Reservas/tok", "Fallos/KB");
+    printf("-------------------------------- -------- ---------- ------------ ------------ ------------\n");
+
+    for(int i = primerFichero; i < argc; i++){
+        size_t longitud;
+        char *datos = cargarFichero(argv[i], &longitud);
+
+        if(datos == NULL) return EXIT_FAILURE;
+
+        const char *nombre = strrchr(argv[i], '/') != NULL ? strrchr(argv[i], '/') + 1 : argv[i];
+
+        imprimirMedida(nombre, "entrada", medirFase(faseEntrada, repeticiones, argv[i], datos, longitud), longitud);
+        imprimirMedida(nombre, "lexico", medirFase(faseLexico, repeticiones, argv[i], datos, longitud), longitud);
+        imprimirMedida(nombre, "memoria", medirFase(faseMemoria, repeticiones, argv[i], datos, longitud), longitud);
+        imprimirMedida(nombre, "columnas", medirFase(faseColumnas, repeticiones, argv[i], datos, longitud), longitud);
+        imprimirMedida(nombre, "empaque", medirFase(faseEmpaquetado, repeticiones, argv[i], datos, longitud), longitud);
+
+        free(datos);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+# -*- coding: utf-8 -*-
+"""
+Compara el rendimiento de dos versiones de miCompilador (base y candidata).
+
+Ejecuta ambas versiones sobre los mismos ficheros N veces, alternando el orden
+en cada repetición, guarda los tiempos de cada ejecución en un CSV y aplica el
+test de Wilcoxon de wilcoxon.py a las parejas de tiempos para decidir si la
+diferencia es significativa o solo ruido.
+
+Uso: python3 bench/compararAB.py BASE CANDIDATA [-n repeticiones] [-a alfa]
+                                 [-o resultados.csv] [--args "-b 65536"] fichero...
+"""
+
+import argparse
+import csv
+import math
+import os
+import shlex
+import statistics
+import subprocess
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+from wilcoxon import wilcoxon_test
+
+
+def medir(ejecutable, argumentos, fichero):
+    """
+    Ejecuta una versión sobre un fichero y devuelve los segundos que tarda.
+    """
+    inicio = time.perf_counter()
+    subprocess.run([ejecutable] + argumentos + [fichero], stdout=subprocess.DEVNULL, check=True)
+    return time.perf_counter() - inicio
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Comparación A/B de dos versiones de miCompilador')
+    parser.add_argument('base', help='ejecutable de referencia')
+    parser.add_argument('candidata', help='ejecutable a evaluar')
+    parser.add_argument('ficheros', nargs='+', help='ficheros de entrada (por ejemplo el corpus de make bench)')
+    parser.add_argument('-n', '--repeticiones', type=int, default=10)
+    parser.add_argument('-a', '--alfa', type=float, default=5e-2, choices=[5e-2, 1e-2])
+    parser.add_argument('-o', '--resultados', default='resultadosAB.csv', help='CSV con el tiempo de cada ejecución')
+    parser.add_argument('--args', default='', help='opciones que se pasan a ambas versiones')
+    opciones = parser.parse_args()
+
+    argumentos = shlex.split(opciones.args)
+    tiempos = {fichero: ([], []) for fichero in opciones.ficheros}
+
+    with open(opciones.resultados, 'w', newline='') as salida:
+        resultados = csv.writer(salida)
+        resultados.writerow(['fichero', 'repeticion', 'base_s', 'candidata_s'])
+
+        for repeticion in range(opciones.repeticiones):
+            for fichero in opciones.ficheros:
+                # Se alterna el orden para que la caché de ficheros y la frecuencia de la CPU
+                # no favorezcan siempre a la misma versión
+                if repeticion % 2 == 0:
+                    base = medir(opciones.base, argumentos, fichero)
+                    candidata = medir(opciones.candidata, argumentos, fichero)
+                else:
+                    candidata = medir(opciones.candidata, argumentos, fichero)
+                    base = medir(opciones.base, argumentos, fichero)
+
+                tiempos[fichero][0].append(base)
+                tiempos[fichero][1].append(candidata)
+                resultados.writerow([fichero, repeticion, '%.6f' % base, '%.6f' % candidata])
+
+    print('%-32s %12s %13s %9s' % ('Fichero', 'Base (s)', 'Candidata (s)', 'Cambio'))
+    print('-------------------------------- ------------ ------------- ---------')
+
+    todosBase, todosCandidata = [], []
+
+    for fichero, (base, candidata) in tiempos.items():
+        medianaBase, medianaCandidata = statistics.median(base), statistics.median(candidata)
+        print('%-32s %12.4f %13.4f %+8.1f%%' % (os.path.basename(fichero), medianaBase, medianaCandidata,
+                                               (medianaCandidata / medianaBase - 1) * 100))
+        todosBase += base
+        todosCandidata += candidata
+
+    # Cada pareja es la misma entrada ejecutada con ambas versiones en la misma repetición. Se
+    # comparan los logaritmos para que cuente el cambio relativo y no pesen más los ficheros grandes
+    logBase = [math.log(t) for t in todosBase]
+    logCandidata = [math.log(t) for t in todosCandidata]
+    test = wilcoxon_test(logBase, logCandidata, opciones.alfa)
+    cambio = (math.exp(statistics.mean(logCandidata) - statistics.mean(logBase)) - 1) * 100
+
+    # Con más de 30 parejas se usa la aproximación normal y el valor crítico es el p-valor
+    print('\nWilcoxon con %d parejas: estadístico %.3f, valor crítico o p-valor %s' % (len(todosBase), test['statistic'], test['critical']))
+
+    if test['result']:
+        print('Sin diferencia significativa (alfa = %g)' % opciones.alfa)
+    elif cambio < 0:
+        print('Mejora significativa: %.1f%% menos tiempo (alfa = %g)' % (-cambio, opciones.alfa))
+    else:
+        print('Regresión significativa: %.1f%% más tiempo (alfa = %g)' % (cambio, opciones.alfa))
+
+    print('Tiempos guardados en %s' % opciones.resultados)
+
+    # Código de salida distinto de 0 si la candidata es significativamente más lenta
+    return 1 if not test['result'] and cambio > 0 else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
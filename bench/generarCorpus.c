@@ -0,0 +1,432 @@
+/**
+ * @file generarCorpus.c
+ * @date 19/10/2026
+ * @brief Generador de código Python sintético para las pruebas de rendimiento
+ *
+ * Genera ficheros de Python del tamaño indicado mezclando varios tipos de
+ * líneas: identificadores y palabras reservadas, literales numéricos (enteros
+ * decimales, hexadecimales, octales y binarios, reales e imaginarios), strings largos, comentarios de
+ * triples comillas y operadores. Algunas líneas abren un bloque (if, for, while,
+ * with o def) cuyo cuerpo va sangrado, y más adelante se vuelve a un nivel
+ * anterior, de modo que el fichero es Python válido. Con la misma semilla se
+ * genera siempre el mismo fichero, de modo que las medidas de distintas
+ * versiones son comparables.
+ *
+ * Uso: generarCorpus [-t tamaño[K|M]] [-s semilla] [-m mezcla] [-o fichero]
+ *  -> mezcla: mixto, ids, numeros, strings, comentarios, operadores o una lista
+ *     de pesos como "ids=4,numeros=1,operadores=2"
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+
+// Tipos de línea que se pueden generar
+enum tipoLinea { LINEA_IDS, LINEA_NUMEROS, LINEA_STRINGS, LINEA_COMENTARIOS, LINEA_OPERADORES, NUM_TIPOS };
+
+static const char *nombresTipos[NUM_TIPOS] = { "ids", "numeros", "strings", "comentarios", "operadores" };
+
+// Tipos de cabecera de bloque
+enum tipoCabecera { CABECERA_IF, CABECERA_FOR, CABECERA_WHILE, CABECERA_WITH, CABECERA_DEF, NUM_CABECERAS };
+
+// Palabras reservadas de Python y nombres a los que no se puede asignar, que no pueden salir como identificadores
+static const char *palabrasReservadas[] = { "False", "None", "True", "and", "as", "assert", "async", "await", "break",
+                                            "class", "continue", "def", "del", "elif", "else", "except", "finally",
+                                            "for", "from", "global", "if", "import", "in", "is", "lambda", "nonlocal",
+                                            "not", "or", "pass", "raise", "return", "try", "while", "with", "yield",
+                                            "__debug__" };
+
+#define NUM_RESERVADAS (sizeof(palabrasReservadas) / sizeof(palabrasReservadas[0]))
+#define MAX_NIVEL_SANGRIA 4
+
+static const char *operadores[] = { "+", "-", "*", "/", "%", "**", "//", "<<", ">>", "&", "|", "^",
+                                    "<", ">", "<=", ">=", "==", "!=", "@" };
+
+static const char *asignaciones[] = { "=", "+=", "-=", "*=", "/=", "//=", "%=", "@=", "&=", "|=", "^=",
+                                      ">>=", "<<=", "**=" };
+
+static uint64_t estadoAleatorio; // Estado del generador xorshift64*
+static FILE *salida; // Fichero generado
+static size_t bytesEscritos; // Bytes escritos en el fichero generado
+static int nivelSangria; // Bloques abiertos en la línea actual, todos los niveles hasta él están en la pila
+
+// Funciones privadas
+uint64_t aleatorio();
+int entre(int minimo, int maximo);
+void escribir(const char *formato, ...);
+void escribirCaracter(char c);
+void escribirIdentificador();
+void escribirNumero();
+void escribirSangria();
+void escribirCabecera(int tipo);
+void escribirLinea(int tipo);
+int leerMezcla(const char *mezcla, int pesos[NUM_TIPOS]);
+size_t leerTamano(const char *texto);
+
+int main(int argc, char *argv[]){
+
+    size_t tamano = 1 << 20;
+    uint64_t semilla = 1;
+    const char *mezcla = "mixto";
+    int pesos[NUM_TIPOS];
+
+    salida = stdout;
+
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "-t") == 0 && i + 1 < argc) tamano = leerTamano(argv[++i]);
+        else if(strcmp(argv[i], "-s") == 0 && i + 1 < argc) semilla = strtoull(argv[++i], NULL, 10);
+        else if(strcmp(argv[i], "-m") == 0 && i + 1 < argc) mezcla = argv[++i];
+        else if(strcmp(argv[i], "-o") == 0 && i + 1 < argc){
+            if( (salida = fopen(argv[++i], "w")) == NULL ){
+                fprintf(stderr, "ERROR: No se pudo crear el fichero %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else {
+            fprintf(stderr, "Uso: %s [-t tamaño[K|M]] [-s semilla] [-m mezcla] [-o fichero]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if(tamano == 0 || !leerMezcla(mezcla, pesos)){
+        fprintf(stderr, "ERROR: Tamaño o mezcla incorrectos\n");
+        return EXIT_FAILURE;
+    }
+
+    int pesoTotal = 0;
+    for(int t = 0; t < NUM_TIPOS; t++) pesoTotal += pesos[t];
+
+    // xorshift no puede partir de 0
+    estadoAleatorio = semilla * 0x9E3779B97F4A7C15ULL + 1;
+
+    while(bytesEscritos < tamano){
+        int valor = entre(0, pesoTotal - 1), tipo = 0;
+
+        while(valor >= pesos[tipo]){
+            valor -= pesos[tipo];
+            tipo++;
+        }
+
+        escribirLinea(tipo);
+    }
+
+    if(salida != stdout) fclose(salida);
+
+    return EXIT_SUCCESS;
+}
+
+//------------------------------------------ FUNCIONES PRIVADAS --------------------------------------------------
+
+// Siguiente número del generador xorshift64*
+uint64_t aleatorio(){
+    estadoAleatorio ^= estadoAleatorio >> 12;
+    estadoAleatorio ^= estadoAleatorio << 25;
+    estadoAleatorio ^= estadoAleatorio >> 27;
+
+    return estadoAleatorio * 0x2545F4914F6CDD1DULL;
+}
+
+// Número aleatorio en [minimo, maximo]
+int entre(int minimo, int maximo){
+    return minimo + (int) (aleatorio() % (uint64_t) (maximo - minimo + 1));
+}
+
+// Escribe en el fichero generado
+void escribir(const char *formato, ...){
+
+    va_list argumentos;
+
+    va_start(argumentos, formato);
+    int escritos = vfprintf(salida, formato, argumentos);
+    va_end(argumentos);
+
+    if(escritos > 0) bytesEscritos += escritos;
+}
+
+// Escribe un caracter en el fichero generado
+void escribirCaracter(char c){
+    fputc(c, salida);
+    bytesEscritos++;
+}
+
+// Escribe un identificador. Si coincide con una palabra reservada se le añade un '_'
+void escribirIdentificador(){
+
+    static const char primeros[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_";
+    static const char siguientes[] = "abcdefghijklmnopqrstuvwxyz_0123456789";
+
+    char identificador[18];
+    int longitud = entre(1, 16);
+
+    identificador[0] = primeros[entre(0, sizeof(primeros) - 2)];
+    for(int i = 1; i < longitud; i++){
+        identificador[i] = siguientes[entre(0, sizeof(siguientes) - 2)];
+    }
+    identificador[longitud] = '\0';
+
+    for(size_t i = 0; i < NUM_RESERVADAS; i++){
+        if(strcmp(identificador, palabrasReservadas[i]) == 0){
+            identificador[longitud] = '_';
+            identificador[longitud + 1] = '\0';
+            break;
+        }
+    }
+
+    escribir("%s", identificador);
+}
+
+// Escribe un literal numérico de cualquiera de los tipos que reconoce automataNumeros
+void escribirNumero(){
+
+    switch(entre(0, 8)){
+        case 0: escribir("%d", entre(1, 999999)); break;
+        case 1: escribir("%d_%03d", entre(1, 999), entre(0, 999)); break;
+        case 2: escribir("0x%X", entre(0, 0xFFFFFF)); break;
+        case 3: escribir("0b%d%d%d1", entre(0, 1), entre(0, 1), entre(0, 1)); break;
+        case 4: escribir("0o_%d%d", entre(1, 7), entre(0, 7)); break;
+        case 5: escribir("%d.%d", entre(0, 9999), entre(0, 999)); break;
+        case 6: escribir(".%d", entre(1, 9999)); break;
+        case 7: escribir("%de%d", entre(1, 99), entre(1, 30)); break;
+        case 8: escribir("%d.%dj", entre(0, 99), entre(0, 99)); break;
+    }
+}
+
+// Escribe la sangría del nivel actual
+void escribirSangria(){
+    escribir("%*s", nivelSangria * 4, "");
+}
+
+// Escribe la cabecera de un bloque, sin el salto de línea
+void escribirCabecera(int tipo){
+
+    switch(tipo){
+
+        case CABECERA_IF:
+            escribir("if ");
+            escribirIdentificador();
+            escribir(entre(0, 1) ? " not in " : " is not ");
+            escribirIdentificador();
+            break;
+
+        case CABECERA_FOR:
+            escribir("for ");
+            escribirIdentificador();
+            escribir(" in ");
+            escribirIdentificador();
+            break;
+
+        case CABECERA_WHILE:
+            escribir("while not ");
+            escribirIdentificador();
+            break;
+
+        case CABECERA_WITH:
+            escribir("with ");
+            escribirIdentificador();
+            escribir("() as ");
+            escribirIdentificador();
+            break;
+
+        case CABECERA_DEF:
+            escribir("def ");
+            escribirIdentificador();
+            escribirCaracter('(');
+            for(int i = entre(0, 3); i > 0; i--){
+                escribirIdentificador();
+                if(i > 1) escribir(", ");
+            }
+            escribir(") -> ");
+            escribirIdentificador();
+            break;
+    }
+
+    escribirCaracter(':');
+}
+
+// Escribe una línea (o un bloque de líneas) del tipo indicado. A veces vuelve antes a un nivel de
+// sangría anterior o abre un bloque cuyo cuerpo empieza con la línea
+void escribirLinea(int tipo){
+
+    int cabecera = -1;
+
+    if(nivelSangria > 0 && entre(0, 3) == 0) nivelSangria = entre(0, nivelSangria - 1);
+
+    // Un comentario no sirve de cuerpo de un bloque
+    if(tipo != LINEA_COMENTARIOS && nivelSangria < MAX_NIVEL_SANGRIA && entre(0, 5) == 0){
+        cabecera = entre(0, NUM_CABECERAS - 1);
+        escribirSangria();
+        escribirCabecera(cabecera);
+        escribirCaracter('\n');
+        nivelSangria++;
+    }
+
+    escribirSangria();
+
+    switch(tipo){
+
+        case LINEA_IDS:
+            if(entre(0, 7) == 0){
+                if(entre(0, 1)){
+                    escribir("import ");
+                    escribirIdentificador();
+                } else {
+                    escribir("from ");
+                    escribirIdentificador();
+                    escribir(" import ");
+                    escribirIdentificador();
+                    escribir(" as ");
+                    escribirIdentificador();
+                }
+                break;
+            }
+
+            escribirIdentificador();
+            escribir(" = ");
+            escribirIdentificador();
+            escribirCaracter('.');
+            escribirIdentificador();
+            escribirCaracter('(');
+            for(int i = entre(0, 4); i > 0; i--){
+                escribirIdentificador();
+                if(i > 1) escribir(", ");
+            }
+            escribirCaracter(')');
+
+            if(entre(0, 3) == 0){
+                escribir(" if ");
+                escribirIdentificador();
+                escribir(" else ");
+                escribirIdentificador();
+            }
+            break;
+
+        case LINEA_NUMEROS:
+            escribirIdentificador();
+            escribir(" = ");
+            for(int i = entre(1, 6); i > 0; i--){
+                escribirNumero();
+                if(i > 1) escribir(" %s ", operadores[entre(0, 3)]);
+            }
+            break;
+
+        case LINEA_STRINGS: {
+            char comilla = entre(0, 1) ? '"' : '\'';
+            int longitud = entre(20, 400);
+
+            escribirIdentificador();
+            escribir(" = %c", comilla);
+            for(int i = 0; i < longitud; i++){
+                escribirCaracter(entre(0, 6) == 0 ? ' ' : 'a' + entre(0, 25));
+            }
+            escribirCaracter(comilla);
+            break;
+        }
+
+        case LINEA_COMENTARIOS: {
+            const char *comillas = entre(0, 1) ? "\"\"\"" : "'''";
+
+            if(entre(0, 2) == 0){
+                escribir("# ");
+                for(int i = entre(10, 80); i > 0; i--) escribirCaracter('a' + entre(0, 25));
+                break;
+            }
+
+            escribir("%s", comillas);
+            for(int lineas = entre(1, 8); lineas > 0; lineas--){
+                for(int i = entre(10, 70); i > 0; i--) escribirCaracter(entre(0, 5) == 0 ? ' ' : 'a' + entre(0, 25));
+                escribirCaracter('\n');
+            }
+            escribir("%s", comillas);
+            break;
+        }
+
+        case LINEA_OPERADORES: {
+            int parentesis = 0;
+
+            escribirIdentificador();
+            escribir("%s", asignaciones[entre(0, 13)]);
+            for(int i = entre(2, 10); i > 0; i--){
+                if(entre(0, 3) == 0){
+                    escribirCaracter('(');
+                    parentesis++;
+                }
+                escribirIdentificador();
+                if(entre(0, 5) == 0) escribir("[%d]", entre(0, 9));
+                if(i > 1) escribir("%s", operadores[entre(0, 18)]);
+            }
+
+            // Los paréntesis se cierran en la misma línea para que cada línea sea una línea lógica
+            while(parentesis-- > 0) escribirCaracter(')');
+            escribirCaracter(entre(0, 1) ? ';' : ',');
+            break;
+        }
+    }
+
+    escribirCaracter('\n');
+
+    // Las funciones acaban devolviendo un valor
+    if(cabecera == CABECERA_DEF){
+        escribirSangria();
+        escribir("return ");
+        escribirIdentificador();
+        escribirCaracter('\n');
+    }
+}
+
+// Interpreta la mezcla: un nombre predefinido o una lista de pesos "tipo=peso,..."
+int leerMezcla(const char *mezcla, int pesos[NUM_TIPOS]){
+
+    int pesoTotal = 0;
+
+    if(strcmp(mezcla, "mixto") == 0){
+        pesos[LINEA_IDS] = 4;
+        pesos[LINEA_NUMEROS] = 2;
+        pesos[LINEA_STRINGS] = 1;
+        pesos[LINEA_COMENTARIOS] = 1;
+        pesos[LINEA_OPERADORES] = 2;
+        return 1;
+    }
+
+    for(int t = 0; t < NUM_TIPOS; t++){
+        pesos[t] = strcmp(mezcla, nombresTipos[t]) == 0;
+        pesoTotal += pesos[t];
+    }
+
+    if(pesoTotal > 0) return 1;
+
+    // Lista de pesos
+    char *copia = strdup(mezcla), *contexto = NULL;
+
+    for(char *par = strtok_r(copia, ",", &contexto); par != NULL; par = strtok_r(NULL, ",", &contexto)){
+        char *igual = strchr(par, '=');
+        int t;
+
+        if(igual == NULL) break;
+        *igual = '\0';
+
+        for(t = 0; t < NUM_TIPOS && strcmp(par, nombresTipos[t]) != 0; t++);
+        if(t == NUM_TIPOS) break;
+
+        pesos[t] = atoi(igual + 1);
+        if(pesos[t] < 0) pesos[t] = 0;
+        pesoTotal += pesos[t];
+    }
+
+    free(copia);
+
+    return pesoTotal > 0;
+}
+
+// Interpreta un tamaño con sufijo K o M opcional
+size_t leerTamano(const char *texto){
+
+    char *fin;
+    size_t tamano = strtoull(texto, &fin, 10);
+
+    if(*fin == 'K' || *fin == 'k') tamano <<= 10;
+    else if(*fin == 'M' || *fin == 'm') tamano <<= 20;
+
+    return tamano;
+}
@@ -0,0 +1,472 @@
+/**
+ * @file cacheTokens.c
+ * @date 19/10/2026
+ * @brief Caché en disco de los componentes léxicos de una entrada
+ *
+ * Formato de un fichero (en el orden de bytes de la máquina, la marca de la
+ * cabecera descarta los de otra): cabecera, palabras de los componentes,
+ * inicios de los símbolos y texto de los símbolos. La cabecera ocupa un
+ * múltiplo de 8 bytes para que las palabras queden alineadas en la proyección.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "cacheTokens.h"
+
+#define MARCA_CACHE 0x4b545950 // "PYTK"
+#define EXTENSION_CACHE ".ptk"
+#define PREFIJO_TEMPORAL ".tmp-"
+#define ANTIGUEDAD_TEMPORAL 3600 // Segundos tras los que un fichero temporal se considera abandonado
+
+// Constantes de xxHash64
+#define PRIMO64_1 0x9E3779B185EBCA87ULL
+#define PRIMO64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIMO64_3 0x165667B19E3779F9ULL
+#define PRIMO64_4 0x85EBCA77C2B2AE63ULL
+#define PRIMO64_5 0x27D4EB2F165667C5ULL
+
+// Cabecera de un fichero de la caché
+typedef struct cabeceraCache {
+    uint32_t marca;
+    uint32_t formato; // VERSION_FORMATO_CACHE
+    claveCache clave;
+    uint64_t numPalabras;
+    uint64_t componentes;
+    uint64_t fin;
+    uint64_t numSimbolos;
+    uint64_t tamTextoSimbolos;
+    int32_t primerSimbolo;
+    uint32_t relleno;
+} cabeceraCache;
+
+// Fichero de la caché encontrado al recorrer el directorio
+typedef struct ficheroCache {
+    char *nombre;
+    struct timespec ultimoUso; // Fecha de modificación
+    size_t tamano;
+} ficheroCache;
+
+// Funciones privadas
+uint64_t rotar64(uint64_t valor, int bits);
+uint64_t leerPalabra64(const unsigned char *p);
+uint32_t leerPalabra32(const unsigned char *p);
+uint64_t rondaHash(uint64_t acumulador, uint64_t valor);
+uint64_t mezclarAcumulador(uint64_t hash, uint64_t acumulador);
+char *rutaEntrada(const cacheTokens *cache, const claveCache *clave);
+int contenidoValido(const cabeceraCache *cabecera, const claveCache *clave, size_t tamFichero);
+int escribirTodo(int descriptor, const void *datos, size_t longitud);
+void expulsarEntradas(cacheTokens *cache);
+int compararUso(const void *a, const void *b);
+int esEntradaCache(const char *nombre);
+
+// xxHash64: cuatro acumuladores independientes sobre bloques de 32 bytes y el resto al final
+uint64_t hashContenido(const char *datos, size_t longitud){
+
+    const unsigned char *p = (const unsigned char *) datos;
+    const unsigned char *fin = p + longitud;
+    uint64_t hash;
+
+    if(longitud >= 32){
+        uint64_t v1 = PRIMO64_1 + PRIMO64_2, v2 = PRIMO64_2, v3 = 0, v4 = -PRIMO64_1;
+        const unsigned char *limite = fin - 32;
+
+        do {
+            v1 = rondaHash(v1, leerPalabra64(p));
+            v2 = rondaHash(v2, leerPalabra64(p + 8));
+            v3 = rondaHash(v3, leerPalabra64(p + 16));
+            v4 = rondaHash(v4, leerPalabra64(p + 24));
+            p += 32;
+        } while(p <= limite);
+
+        hash = rotar64(v1, 1) + rotar64(v2, 7) + rotar64(v3, 12) + rotar64(v4, 18);
+        hash = mezclarAcumulador(hash, v1);
+        hash = mezclarAcumulador(hash, v2);
+        hash = mezclarAcumulador(hash, v3);
+        hash = mezclarAcumulador(hash, v4);
+    }
+    else hash = PRIMO64_5;
+
+    hash += (uint64_t) longitud;
+
+    for(; fin - p >= 8; p += 8){
+        hash ^= rondaHash(0, leerPalabra64(p));
+        hash = rotar64(hash, 27) * PRIMO64_1 + PRIMO64_4;
+    }
+
+    if(fin - p >= 4){
+        hash ^= (uint64_t) leerPalabra32(p) * PRIMO64_1;
+        hash = rotar64(hash, 23) * PRIMO64_2 + PRIMO64_3;
+        p += 4;
+    }
+
+    for(; p < fin; p++){
+        hash ^= *p * PRIMO64_5;
+        hash = rotar64(hash, 11) * PRIMO64_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIMO64_2;
+    hash ^= hash >> 29;
+    hash *= PRIMO64_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+// Crea el directorio si no existe y calcula lo que ocupa la caché
+int abrirCacheTokens(cacheTokens *cache, const char *directorio, size_t tamMaximo){
+
+    if(mkdir(directorio, 0777) < 0 && errno != EEXIST){
+        fprintf(stderr, "ERROR cacheTokens.c: no se pudo crear el directorio %s\n", directorio);
+        return 0;
+    }
+
+    if((cache->directorio = strdup(directorio)) == NULL){
+        fprintf(stderr, "ERROR cacheTokens.c: no se pudo reservar memoria para la caché\n");
+        return 0;
+    }
+
+    cache->tamMaximo = tamMaximo;
+    cache->tamEstimado = 0;
+
+    expulsarEntradas(cache);
+
+    return 1;
+}
+
+// Proyecta el fichero de la clave y comprueba que su cabecera corresponde a ella
+int buscarEnCache(cacheTokens *cache, const claveCache *clave, contenidoCache *contenido, void **mapa, size_t *tamMapa){
+
+    char *ruta = rutaEntrada(cache, clave);
+
+    if(ruta == NULL) return 0;
+
+    int descriptor = open(ruta, O_RDONLY);
+    free(ruta);
+
+    if(descriptor < 0) return 0;
+
+    struct stat datos;
+    void *proyeccion = MAP_FAILED;
+
+    if(fstat(descriptor, &datos) == 0 && (size_t) datos.st_size >= sizeof(cabeceraCache)){
+        proyeccion = mmap(NULL, (size_t) datos.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    }
+
+    if(proyeccion == MAP_FAILED){
+        close(descriptor);
+        return 0;
+    }
+
+    const cabeceraCache *cabecera = (const cabeceraCache *) proyeccion;
+
+    // Un fichero que no corresponde a la clave se trata como un fallo y se sobrescribirá
+    if(!contenidoValido(cabecera, clave, (size_t) datos.st_size)){
+        munmap(proyeccion, (size_t) datos.st_size);
+        close(descriptor);
+        return 0;
+    }
+
+    // La fecha de modificación es la del último uso: decide el orden de expulsión
+    futimens(descriptor, NULL);
+    close(descriptor);
+
+    const char *p = (const char *) proyeccion + sizeof(cabeceraCache);
+
+    contenido->palabras = (const uint64_t *) p;
+    contenido->numPalabras = (size_t) cabecera->numPalabras;
+    contenido->componentes = (size_t) cabecera->componentes;
+    contenido->fin = (size_t) cabecera->fin;
+    p += contenido->numPalabras * sizeof(uint64_t);
+
+    contenido->iniciosSimbolos = (const uint32_t *) p;
+    contenido->numSimbolos = (size_t) cabecera->numSimbolos;
+    contenido->primerSimbolo = cabecera->primerSimbolo;
+    p += contenido->numSimbolos * sizeof(uint32_t);
+
+    contenido->textoSimbolos = p;
+    contenido->tamTextoSimbolos = (size_t) cabecera->tamTextoSimbolos;
+
+    *mapa = proyeccion;
+    *tamMapa = (size_t) datos.st_size;
+
+    return 1;
+}
+
+// Escribe la entrada en un fichero temporal del directorio y lo renombra: rename sustituye el fichero
+// de forma atómica, así que quien lo abra ve el anterior entero o el nuevo entero
+int guardarEnCache(cacheTokens *cache, const claveCache *clave, const contenidoCache *contenido){
+
+    cabeceraCache cabecera;
+
+    memset(&cabecera, 0, sizeof(cabeceraCache));
+    cabecera.marca = MARCA_CACHE;
+    cabecera.formato = VERSION_FORMATO_CACHE;
+    cabecera.clave = *clave;
+    cabecera.numPalabras = contenido->numPalabras;
+    cabecera.componentes = contenido->componentes;
+    cabecera.fin = contenido->fin;
+    cabecera.numSimbolos = contenido->numSimbolos;
+    cabecera.tamTextoSimbolos = contenido->tamTextoSimbolos;
+    cabecera.primerSimbolo = contenido->primerSimbolo;
+
+    size_t tamFichero = sizeof(cabeceraCache) + contenido->numPalabras * sizeof(uint64_t)
+                        + contenido->numSimbolos * sizeof(uint32_t) + contenido->tamTextoSimbolos;
+
+    // Una entrada mayor que la caché entera la vaciaría sin llegar a caber
+    if(tamFichero > cache->tamMaximo) return 0;
+
+    char *ruta = rutaEntrada(cache, clave);
+    size_t longitudTemporal = strlen(cache->directorio) + sizeof("/" PREFIJO_TEMPORAL "XXXXXX");
+    char *temporal = (char *) malloc(longitudTemporal);
+
+    if(ruta == NULL || temporal == NULL){
+        free(ruta);
+        free(temporal);
+        return 0;
+    }
+
+    snprintf(temporal, longitudTemporal, "%s/" PREFIJO_TEMPORAL "XXXXXX", cache->directorio);
+
+    int descriptor = mkstemp(temporal);
+    int correcto = descriptor >= 0;
+
+    if(correcto){
+        fchmod(descriptor, 0644);
+
+        correcto = escribirTodo(descriptor, &cabecera, sizeof(cabeceraCache))
+                   && escribirTodo(descriptor, contenido->palabras, contenido->numPalabras * sizeof(uint64_t))
+                   && escribirTodo(descriptor, contenido->iniciosSimbolos, contenido->numSimbolos * sizeof(uint32_t))
+                   && escribirTodo(descriptor, contenido->textoSimbolos, contenido->tamTextoSimbolos);
+
+        correcto = close(descriptor) == 0 && correcto && rename(temporal, ruta) == 0;
+
+        if(!correcto) unlink(temporal);
+    }
+
+    free(temporal);
+    free(ruta);
+
+    if(!correcto) return 0;
+
+    cache->tamEstimado += tamFichero;
+
+    if(cache->tamEstimado > cache->tamMaximo) expulsarEntradas(cache);
+
+    return 1;
+}
+
+// Deshace la proyección de una entrada
+void liberarEntradaCache(void *mapa, size_t tamMapa){
+    if(mapa != NULL) munmap(mapa, tamMapa);
+}
+
+// Libera la ruta del directorio
+void cerrarCacheTokens(cacheTokens *cache){
+
+    free(cache->directorio);
+
+    memset(cache, 0, sizeof(cacheTokens));
+}
+
+//------------------------------------------ FUNCIONES PRIVADAS --------------------------------------------------
+
+uint64_t rotar64(uint64_t valor, int bits){
+    return (valor << bits) | (valor >> (64 - bits));
+}
+
+// Lecturas sin alinear, como en el resto del hash se usa el orden de bytes de la máquina
+uint64_t leerPalabra64(const unsigned char *p){
+
+    uint64_t valor;
+
+    memcpy(&valor, p, sizeof(valor));
+
+    return valor;
+}
+
+uint32_t leerPalabra32(const unsigned char *p){
+
+    uint32_t valor;
+
+    memcpy(&valor, p, sizeof(valor));
+
+    return valor;
+}
+
+// Añade 8 bytes a un acumulador
+uint64_t rondaHash(uint64_t acumulador, uint64_t valor){
+
+    acumulador += valor * PRIMO64_2;
+    acumulador = rotar64(acumulador, 31);
+
+    return acumulador * PRIMO64_1;
+}
+
+// Mezcla un acumulador con el hash al acabar los bloques de 32 bytes
+uint64_t mezclarAcumulador(uint64_t hash, uint64_t acumulador){
+
+    hash ^= rondaHash(0, acumulador);
+
+    return hash * PRIMO64_1 + PRIMO64_4;
+}
+
+// Ruta del fichero de una clave: hash-longitud-vVERSION-oOPCIONES.ptk
+char *rutaEntrada(const cacheTokens *cache, const claveCache *clave){
+
+    size_t longitud = strlen(cache->directorio) + 64;
+    char *ruta = (char *) malloc(longitud);
+
+    if(ruta == NULL) return NULL;
+
+    snprintf(ruta, longitud, "%s/%016" PRIx64 "-%" PRIx64 "-v%" PRIu32 "-o%" PRIu32 EXTENSION_CACHE,
+             cache->directorio, clave->hash, clave->longitud, clave->version, clave->opciones);
+
+    return ruta;
+}
+
+// Comprueba la cabecera y que las secciones ocupan el fichero entero. Los símbolos deben empezar dentro
+// del texto y el texto acabar en '\0', así que todos los lexemas están terminados
+int contenidoValido(const cabeceraCache *cabecera, const claveCache *clave, size_t tamFichero){
+
+    if(cabecera->marca != MARCA_CACHE || cabecera->formato != VERSION_FORMATO_CACHE
+       || memcmp(&cabecera->clave, clave, sizeof(claveCache)) != 0){
+        return 0;
+    }
+
+    size_t resto = tamFichero - sizeof(cabeceraCache);
+
+    if(cabecera->numPalabras > resto / sizeof(uint64_t)) return 0;
+    resto -= (size_t) cabecera->numPalabras * sizeof(uint64_t);
+
+    if(cabecera->numSimbolos > resto / sizeof(uint32_t)) return 0;
+    resto -= (size_t) cabecera->numSimbolos * sizeof(uint32_t);
+
+    if(cabecera->tamTextoSimbolos != resto) return 0;
+
+    const char *inicio = (const char *) cabecera + sizeof(cabeceraCache);
+    const uint32_t *inicios = (const uint32_t *) (inicio + cabecera->numPalabras * sizeof(uint64_t));
+    const char *texto = (const char *) (inicios + cabecera->numSimbolos);
+
+    if(cabecera->numSimbolos > 0 && (resto == 0 || texto[resto - 1] != '\0')) return 0;
+
+    for(size_t i = 0; i < cabecera->numSimbolos; i++){
+        if(inicios[i] >= resto) return 0;
+    }
+
+    return 1;
+}
+
+// Escribe todos los bytes, reintentando las escrituras parciales
+int escribirTodo(int descriptor, const void *datos, size_t longitud){
+
+    const char *p = (const char *) datos;
+
+    while(longitud > 0){
+        ssize_t escritos = write(descriptor, p, longitud);
+
+        if(escritos < 0){
+            if(errno == EINTR) continue;
+            return 0;
+        }
+
+        p += escritos;
+        longitud -= (size_t) escritos;
+    }
+
+    return 1;
+}
+
+// Recorre el directorio, borra los temporales abandonados y, si la caché ocupa más de su tamaño máximo,
+// las entradas usadas hace más tiempo hasta que ocupa el 90%. El margen evita recorrer el directorio en
+// cada escritura. Otros procesos pueden estar borrando las mismas entradas: los fallos se ignoran
+void expulsarEntradas(cacheTokens *cache){
+
+    DIR *directorio = opendir(cache->directorio);
+
+    if(directorio == NULL) return;
+
+    ficheroCache *ficheros = NULL;
+    size_t numFicheros = 0, capacidad = 0, total = 0;
+    struct dirent *entrada;
+    time_t ahora = time(NULL);
+
+    while((entrada = readdir(directorio)) != NULL){
+        struct stat datos;
+        int temporal = strncmp(entrada->d_name, PREFIJO_TEMPORAL, strlen(PREFIJO_TEMPORAL)) == 0;
+
+        if(!temporal && !esEntradaCache(entrada->d_name)) continue;
+
+        if(fstatat(dirfd(directorio), entrada->d_name, &datos, AT_SYMLINK_NOFOLLOW) < 0 || !S_ISREG(datos.st_mode)) continue;
+
+        if(temporal){
+            if(ahora - datos.st_mtime > ANTIGUEDAD_TEMPORAL) unlinkat(dirfd(directorio), entrada->d_name, 0);
+            continue;
+        }
+
+        if(numFicheros == capacidad){
+            size_t nuevaCapacidad = capacidad ? capacidad * 2 : 64;
+            ficheroCache *nuevos = (ficheroCache *) realloc(ficheros, nuevaCapacidad * sizeof(ficheroCache));
+
+            if(nuevos == NULL) break;
+
+            ficheros = nuevos;
+            capacidad = nuevaCapacidad;
+        }
+
+        if((ficheros[numFicheros].nombre = strdup(entrada->d_name)) == NULL) break;
+
+        ficheros[numFicheros].ultimoUso = datos.st_mtim;
+        ficheros[numFicheros].tamano = (size_t) datos.st_size;
+        total += ficheros[numFicheros].tamano;
+        numFicheros++;
+    }
+
+    if(total > cache->tamMaximo){
+        size_t objetivo = cache->tamMaximo / 10 * 9;
+
+        qsort(ficheros, numFicheros, sizeof(ficheroCache), compararUso);
+
+        for(size_t i = 0; i < numFicheros && total > objetivo; i++){
+            unlinkat(dirfd(directorio), ficheros[i].nombre, 0);
+            total -= ficheros[i].tamano;
+        }
+    }
+
+    for(size_t i = 0; i < numFicheros; i++) free(ficheros[i].nombre);
+
+    free(ficheros);
+    closedir(directorio);
+
+    cache->tamEstimado = total;
+}
+
+// Ordena los ficheros del usado hace más tiempo al más reciente
+int compararUso(const void *a, const void *b){
+
+    const struct timespec *x = &((const ficheroCache *) a)->ultimoUso;
+    const struct timespec *y = &((const ficheroCache *) b)->ultimoUso;
+
+    if(x->tv_sec != y->tv_sec) return x->tv_sec < y->tv_sec ? -1 : 1;
+    if(x->tv_nsec != y->tv_nsec) return x->tv_nsec < y->tv_nsec ? -1 : 1;
+
+    return 0;
+}
+
+// Las entradas de la caché son los ficheros con su extensión
+int esEntradaCache(const char *nombre){
+
+    size_t longitud = strlen(nombre);
+    size_t longitudExtension = strlen(EXTENSION_CACHE);
+
+    return longitud > longitudExtension && strcmp(nombre + longitud - longitudExtension, EXTENSION_CACHE) == 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file cacheTokens.h
+ * @date 19/10/2026
+ * @brief Caché en disco de los componentes léxicos de una entrada
+ *
+ * Cada entrada se guarda en un fichero del directorio de la caché cuyo nombre
+ * sale de un hash del contenido, su longitud, la versión del analizador y las
+ * opciones del análisis. El fichero tiene una cabecera, los componentes
+ * empaquetados y la lista de símbolos, y se lee proyectándolo en memoria.
+ * Los ficheros se escriben con otro nombre y se renombran al acabar, así que
+ * varios procesos pueden escribir a la vez en el mismo directorio sin que se
+ * lea nunca un fichero a medias. Cuando se supera el tamaño máximo se borran
+ * los ficheros usados hace más tiempo: cada acierto actualiza la fecha de
+ * modificación de su fichero.
+ */
+
+#ifndef CACHETOKENS_H
+#define CACHETOKENS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Versión del formato de los ficheros, se incrementa si cambia su estructura
+#define VERSION_FORMATO_CACHE 1
+
+// Clave de una entrada de la caché
+typedef struct claveCache {
+    uint64_t hash; // hashContenido de la entrada
+    uint64_t longitud; // Longitud de la entrada
+    uint32_t version; // Versión del analizador
+    uint32_t opciones; // Opciones que cambian los componentes generados
+} claveCache;
+
+// Contenido de una entrada de la caché
+typedef struct contenidoCache {
+    const uint64_t *palabras; // Componentes empaquetados
+    size_t numPalabras;
+    size_t componentes; // Componentes guardados (sin contar las palabras de escape)
+    size_t fin; // Fin en la entrada del último componente
+    const uint32_t *iniciosSimbolos; // Inicio de cada símbolo en textoSimbolos
+    size_t numSimbolos;
+    int32_t primerSimbolo; // Identificador del primer símbolo, los demás son consecutivos
+    const char *textoSimbolos; // Lexemas de los símbolos, terminados en '\0'
+    size_t tamTextoSimbolos;
+} contenidoCache;
+
+// Directorio de la caché. No se debe usar desde varios hilos a la vez
+typedef struct cacheTokens {
+    char *directorio;
+    size_t tamMaximo; // Bytes que pueden ocupar los ficheros de la caché
+    size_t tamEstimado; // Bytes que ocupaban en el último recorrido más los escritos desde entonces
+} cacheTokens;
+
+/**
+ * Calcula el hash de 64 bits de una entrada (xxHash64 con semilla 0)
+ * @param datos: caracteres de la entrada
+ * @param longitud: número de caracteres
+ * @return hash de la entrada
+ */
+uint64_t hashContenido(const char *datos, size_t longitud);
+
+/**
+ * Abre el directorio de una caché, creándolo si no existe
+ * @param cache: caché a inicializar
+ * @param directorio: ruta del directorio
+ * @param tamMaximo: bytes que pueden ocupar los ficheros de la caché
+ * @return 1 si se ha abierto, 0 si no se pudo crear el directorio o reservar memoria
+ */
+int abrirCacheTokens(cacheTokens *cache, const char *directorio, size_t tamMaximo);
+
+/**
+ * Busca una entrada en la caché y la proyecta en memoria
+ * @param cache: caché abierta
+ * @param clave: clave de la entrada
+ * @param contenido: se guarda el contenido, que apunta a la proyección
+ * @param mapa: se guarda la proyección, que se libera con liberarEntradaCache
+ * @param tamMapa: se guarda el tamaño de la proyección
+ * @return 1 si se ha encontrado una entrada válida, 0 en caso contrario
+ */
+int buscarEnCache(cacheTokens *cache, const claveCache *clave, contenidoCache *contenido, void **mapa, size_t *tamMapa);
+
+/**
+ * Guarda una entrada en la caché, sustituyendo a la que hubiera con la misma clave, y borra las menos
+ * usadas si se supera el tamaño máximo
+ * @param cache: caché abierta
+ * @param clave: clave de la entrada
+ * @param contenido: contenido a guardar
+ * @return 1 si se ha guardado, 0 si no se pudo escribir (la caché sigue siendo válida)
+ */
+int guardarEnCache(cacheTokens *cache, const claveCache *clave, const contenidoCache *contenido);
+
+/**
+ * Libera la proyección de una entrada encontrada con buscarEnCache
+ * @param mapa: proyección
+ * @param tamMapa: tamaño de la proyección
+ */
+void liberarEntradaCache(void *mapa, size_t tamMapa);
+
+/**
+ * Cierra una caché. Los ficheros se conservan
+ * @param cache: caché a cerrar
+ */
+void cerrarCacheTokens(cacheTokens *cache);
+
+#endif
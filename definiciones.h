@@ -4,25 +4,180 @@
  * @brief Fichero que contiene las definiciones de los componentes léxicos
 */
 
+#ifndef DEFINICIONES_H
+#define DEFINICIONES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
 //--------------------------- Definiciones ------------------------------
 
-// Definiciones para las keywords 
-#define FOR 300
-#define IF 301
-#define ELSE 302
-#define IN 303
-#define NOT 304
-#define RETURN 305
-#define IMPORT 306
-#define FROM 307
-#define AS 308
-
-// Definiciones para los operadores
+/**
+ * Los componentes léxicos de ortografía fija (palabras reservadas, operadores y delimitadores) se
+ * definen una sola vez en las tablas PALABRAS_RESERVADAS y SIGNOS_PUNTUACION. De ellas se generan
+ * los códigos de este fichero, las palabras que se insertan en la tabla de símbolos y la tabla con
+ * la que el analizador léxico reconoce los signos. Para añadir un componente basta con añadir una
+ * fila; los códigos existentes no deben cambiar.
+*/
+
+// Palabras reservadas: X(nombre, código, lexema). False, None, True y del llevan '_' para no chocar
+// con otras definiciones (DEL es la clase de los delimitadores)
+#define PALABRAS_RESERVADAS(X) \
+    X(FOR,      300, "for")      \
+    X(IF,       301, "if")       \
+    X(ELSE,     302, "else")     \
+    X(IN,       303, "in")       \
+    X(NOT,      304, "not")      \
+    X(RETURN,   305, "return")   \
+    X(IMPORT,   306, "import")   \
+    X(FROM,     307, "from")     \
+    X(AS,       308, "as")       \
+    X(FALSE_,   315, "False")    \
+    X(NONE_,    316, "None")     \
+    X(TRUE_,    317, "True")     \
+    X(AND,      318, "and")      \
+    X(ASSERT,   319, "assert")   \
+    X(ASYNC,    320, "async")    \
+    X(AWAIT,    321, "await")    \
+    X(BREAK,    322, "break")    \
+    X(CLASS,    323, "class")    \
+    X(CONTINUE, 324, "continue") \
+    X(DEF,      325, "def")      \
+    X(DEL_,     326, "del")      \
+    X(ELIF,     327, "elif")     \
+    X(EXCEPT,   328, "except")   \
+    X(FINALLY,  329, "finally")  \
+    X(GLOBAL,   330, "global")   \
+    X(IS,       331, "is")       \
+    X(LAMBDA,   332, "lambda")   \
+    X(NONLOCAL, 333, "nonlocal") \
+    X(OR,       334, "or")       \
+    X(PASS,     335, "pass")     \
+    X(RAISE,    336, "raise")    \
+    X(TRY,      337, "try")      \
+    X(WHILE,    338, "while")    \
+    X(WITH,     339, "with")     \
+    X(YIELD,    340, "yield")
+
+#define PRIMERA_PALABRA_RESERVADA 300
+#define ULTIMA_PALABRA_RESERVADA 340
+
+/**
+ * Operadores y delimitadores: X(nombre, código, lexema, clase, primer caracter, forma). La clase es
+ * OP o DEL y la forma indica cómo se construye el signo a partir de su primer caracter (ver
+ * automataPuntuacion): SIGNO_SOLO ('*'), SIGNO_CON_IGUAL ('*='), SIGNO_DOBLE ('**' o '->'),
+ * SIGNO_DOBLE_CON_IGUAL ('**=') y SIGNO_TRIPLE ('...')
+*/
+#define SIGNOS_PUNTUACION(X) \
+    X(MAS,                      400, "+",   OP,  '+', SIGNO_SOLO)            \
+    X(MENOS,                    401, "-",   OP,  '-', SIGNO_SOLO)            \
+    X(POR,                      402, "*",   OP,  '*', SIGNO_SOLO)            \
+    X(POTENCIA,                 403, "**",  OP,  '*', SIGNO_DOBLE)           \
+    X(DIVISION,                 404, "/",   OP,  '/', SIGNO_SOLO)            \
+    X(DIVISION_ENTERA,          405, "//",  OP,  '/', SIGNO_DOBLE)           \
+    X(MODULO,                   406, "%",   OP,  '%', SIGNO_SOLO)            \
+    X(ARROBA,                   407, "@",   OP,  '@', SIGNO_SOLO)            \
+    X(DESPLAZAMIENTO_IZQ,       408, "<<",  OP,  '<', SIGNO_DOBLE)           \
+    X(DESPLAZAMIENTO_DER,       409, ">>",  OP,  '>', SIGNO_DOBLE)           \
+    X(Y_BIT,                    410, "&",   OP,  '&', SIGNO_SOLO)            \
+    X(O_BIT,                    411, "|",   OP,  '|', SIGNO_SOLO)            \
+    X(XOR_BIT,                  412, "^",   OP,  '^', SIGNO_SOLO)            \
+    X(NEGACION_BIT,             413, "~",   OP,  '~', SIGNO_SOLO)            \
+    X(MORSA,                    414, ":=",  OP,  ':', SIGNO_CON_IGUAL)       \
+    X(MENOR,                    415, "<",   OP,  '<', SIGNO_SOLO)            \
+    X(MAYOR,                    416, ">",   OP,  '>', SIGNO_SOLO)            \
+    X(MENOR_IGUAL,              417, "<=",  OP,  '<', SIGNO_CON_IGUAL)       \
+    X(MAYOR_IGUAL,              418, ">=",  OP,  '>', SIGNO_CON_IGUAL)       \
+    X(IGUAL,                    419, "==",  OP,  '=', SIGNO_CON_IGUAL)       \
+    X(DISTINTO,                 420, "!=",  OP,  '!', SIGNO_CON_IGUAL)       \
+    X(PARENTESIS_IZQ,           421, "(",   DEL, '(', SIGNO_SOLO)            \
+    X(PARENTESIS_DER,           422, ")",   DEL, ')', SIGNO_SOLO)            \
+    X(CORCHETE_IZQ,             423, "[",   DEL, '[', SIGNO_SOLO)            \
+    X(CORCHETE_DER,             424, "]",   DEL, ']', SIGNO_SOLO)            \
+    X(LLAVE_IZQ,                425, "{",   DEL, '{', SIGNO_SOLO)            \
+    X(LLAVE_DER,                426, "}",   DEL, '}', SIGNO_SOLO)            \
+    X(COMA,                     427, ",",   DEL, ',', SIGNO_SOLO)            \
+    X(DOS_PUNTOS,               428, ":",   DEL, ':', SIGNO_SOLO)            \
+    X(PUNTO,                    429, ".",   DEL, '.', SIGNO_SOLO)            \
+    X(PUNTO_Y_COMA,             430, ";",   DEL, ';', SIGNO_SOLO)            \
+    X(ASIGNACION,               431, "=",   DEL, '=', SIGNO_SOLO)            \
+    X(FLECHA,                   432, "->",  DEL, '-', SIGNO_DOBLE)           \
+    X(MAS_IGUAL,                433, "+=",  DEL, '+', SIGNO_CON_IGUAL)       \
+    X(MENOS_IGUAL,              434, "-=",  DEL, '-', SIGNO_CON_IGUAL)       \
+    X(POR_IGUAL,                435, "*=",  DEL, '*', SIGNO_CON_IGUAL)       \
+    X(DIVISION_IGUAL,           436, "/=",  DEL, '/', SIGNO_CON_IGUAL)       \
+    X(DIVISION_ENTERA_IGUAL,    437, "//=", DEL, '/', SIGNO_DOBLE_CON_IGUAL) \
+    X(MODULO_IGUAL,             438, "%=",  DEL, '%', SIGNO_CON_IGUAL)       \
+    X(ARROBA_IGUAL,             439, "@=",  DEL, '@', SIGNO_CON_IGUAL)       \
+    X(Y_BIT_IGUAL,              440, "&=",  DEL, '&', SIGNO_CON_IGUAL)       \
+    X(O_BIT_IGUAL,              441, "|=",  DEL, '|', SIGNO_CON_IGUAL)       \
+    X(XOR_BIT_IGUAL,            442, "^=",  DEL, '^', SIGNO_CON_IGUAL)       \
+    X(DESPLAZAMIENTO_DER_IGUAL, 443, ">>=", DEL, '>', SIGNO_DOBLE_CON_IGUAL) \
+    X(DESPLAZAMIENTO_IZQ_IGUAL, 444, "<<=", DEL, '<', SIGNO_DOBLE_CON_IGUAL) \
+    X(POTENCIA_IGUAL,           445, "**=", DEL, '*', SIGNO_DOBLE_CON_IGUAL) \
+    X(EXCLAMACION,              446, "!",   DEL, '!', SIGNO_SOLO)            \
+    X(PUNTOS_SUSPENSIVOS,       447, "...", DEL, '.', SIGNO_TRIPLE)
+
+#define PRIMER_SIGNO 400
+#define ULTIMO_SIGNO 447
+
+// Códigos de las palabras reservadas y de los signos
+#define CODIGO_PALABRA(nombre, codigo, lexema) nombre = codigo,
+#define CODIGO_SIGNO(nombre, codigo, lexema, clase, primero, forma) nombre = codigo,
+
+enum componenteFijo {
+    PALABRAS_RESERVADAS(CODIGO_PALABRA)
+    SIGNOS_PUNTUACION(CODIGO_SIGNO)
+};
+
+#undef CODIGO_PALABRA
+#undef CODIGO_SIGNO
+
+// Componentes de ortografía variable
 #define ID 309
 #define NUM_INT 310
 #define NUM_FLOAT 311
 #define STRING 312
+
+// Clases de los signos (ver claseSigno en analizadorLexico.h)
 #define OP 313
 #define DEL 314
 
+// Estructura de las líneas lógicas: fin de línea lógica y aumento o disminución de la sangría.
+// Su lexema es constante (ver lexemaComponente en analizadorLexico.h)
+#define NEWLINE 350
+#define INDENT 351
+#define DEDENT 352
+
+// Partes de un f-string cuando se separan sus campos de sustitución (ver separarFstrings en
+// analizadorLexico.h): prefijo y comillas de apertura, texto entre campos y comillas de cierre.
+// Los campos se devuelven como '{', los componentes de la expresión, '!' y ':' y '}'
+#define FSTRING_INICIO 360
+#define FSTRING_MEDIO 361
+#define FSTRING_FIN 362
+
+// Tipos del valor de un literal numérico
+#define VALOR_NINGUNO 0       // El componente no es un número
+#define VALOR_ENTERO 1        // Entero que cabe en int64_t
+#define VALOR_ENTERO_GRANDE 2 // Entero que no cabe en int64_t, real tiene su valor aproximado
+#define VALOR_REAL 3
+#define VALOR_IMAGINARIO 4    // real tiene la parte imaginaria
+
+// Valor de un literal numérico, calculado al reconocerlo para no tener que volver a leer el lexema
+typedef struct valorNumerico {
+    int tipo;       // VALOR_...
+    int64_t entero; // Valor si tipo es VALOR_ENTERO
+    double real;    // Valor como double (aproximado en los enteros grandes)
+} valorNumerico;
+
+// Posición de un caracter en la entrada. El desplazamiento se conoce siempre; la línea y la columna
+// se calculan a partir de él con el índice de líneas del sistema de entrada
+typedef struct posicionEntrada {
+    size_t desplazamiento; // Bytes desde el inicio de la entrada
+    int linea; // Empieza en 1
+    int columna; // Empieza en 1, en bytes
+} posicionEntrada;
+
+#endif // DEFINICIONES_H
+
 
@@ -3,7 +3,8 @@
  * @date 20/03/2024
  * @brief Implementación de las funciones de gestion de errores
  * 
- * Gestiona los errores que se producen en el compilador
+ * Gestiona los errores que se producen en el compilador. Registrar un error solo
+ * calcula su posición y lo copia en el registro: el mensaje se forma al imprimirlo
  */
 
 #include <stdio.h>
@@ -11,25 +12,154 @@
 #include "gestionErrores.h"
 #include "../sistemaEntrada/sistemaEntrada.h"
 
-//No se encuentra el fichero y se sale del programa
+// Registro que se usa si no se ha seleccionado otro, y registro seleccionado (propios de cada hilo)
+static _Thread_local registroErrores registroPorDefecto;
+static _Thread_local registroErrores *registroActual = NULL;
+
+// Funciones privadas
+void registrarError(codigoError codigo, int enInicioLexema, size_t dato);
+
+//No se encuentra el fichero
 void ficheroNoEncontrado(char *nombreFichero){
     printf("ERROR: No se ha encontrado el fichero %s\n", nombreFichero);
-    exit(1);
 }
 
 //Se ha excedido el tamaño máximo del lexema
 void tamLexemaExcedido(){
-    printf("ERROR: El tamaño del lexema excede el tamaño máximo permitido (%d)\n", TAM_LEXEMA);
+    registrarError(ERROR_LEXEMA_EXCEDIDO, 1, tamMaximoLexema());
 }
 
 //No se reconoce el caracater
 void caracterNoReconocido(char c){
-    printf("ERROR: Caracter no reconocido: %c\n", c);
+    registrarError(ERROR_CARACTER_NO_RECONOCIDO, 0, (unsigned char) c);
+}
+
+//El fichero o la línea acaba dentro de un string
+void stringSinCerrar(){
+    registrarError(ERROR_STRING_SIN_CERRAR, 1, 0);
+}
+
+//El fichero acaba dentro de un comentario
+void comentarioSinCerrar(){
+    registrarError(ERROR_COMENTARIO_SIN_CERRAR, 1, 0);
+}
+
+//No se pudo reservar memoria
+void errorMemoria(){
+    registrarError(ERROR_MEMORIA, 1, 0);
+}
+
+//El literal numérico no es válido
+void numeroMalFormado(){
+    registrarError(ERROR_NUMERO_MAL_FORMADO, 1, 0);
+}
+
+//La sangría no coincide con ningún nivel abierto
+void sangriaInconsistente(){
+    registrarError(ERROR_SANGRIA_INCONSISTENTE, 0, 0);
+}
+
+//Demasiados niveles de sangría
+void demasiadasSangrias(){
+    registrarError(ERROR_DEMASIADAS_SANGRIAS, 0, 0);
+}
+
+//El f-string se cierra con un campo de sustitución abierto
+void campoFstringSinCerrar(){
+    registrarError(ERROR_CAMPO_FSTRING_SIN_CERRAR, 0, 0);
+}
+
+//La entrada comprimida acaba a mitad de un miembro
+void comprimidoIncompleto(){
+    registrarError(ERROR_COMPRIMIDO_INCOMPLETO, 0, 0);
+}
+
+//La entrada comprimida tiene datos dañados
+void comprimidoDanado(){
+    registrarError(ERROR_COMPRIMIDO_DANADO, 0, 0);
 }
 
 //Se ha excedido el tamaño máximo de la tabla de símbolos
 void numParametrosIncorrecto(){
     printf("ERROR: El numero de parámetros introducido es incorrecto\n");
-    printf("Uso: ./ejecutable <fichero_entrada>\n");
-    exit(1);
+    printf("Uso: ./ejecutable [-b tam_bloque] [-j hilos] [--profile] [--fstrings] [--gzip] <fichero_entrada | archivo.zip | ->\n");
+}
+
+// Selecciona el registro de errores del hilo
+void seleccionarRegistroErrores(registroErrores *registro){
+    registroActual = registro;
+}
+
+// Vacía un registro de errores
+void vaciarRegistroErrores(registroErrores *registro){
+    registro->numErrores = 0;
+    registro->numDescartados = 0;
+}
+
+// Devuelve el mensaje asociado a un código de error
+const char *mensajeError(codigoError codigo){
+
+    switch(codigo){
+        case ERROR_LEXEMA_EXCEDIDO: return "El tamaño del lexema excede el tamaño máximo permitido";
+        case ERROR_CARACTER_NO_RECONOCIDO: return "Caracter no reconocido";
+        case ERROR_STRING_SIN_CERRAR: return "El fichero o la línea acaba antes de cerrar el string";
+        case ERROR_COMENTARIO_SIN_CERRAR: return "El fichero acaba antes de cerrar el comentario";
+        case ERROR_MEMORIA: return "No se pudo reservar memoria para el lexema";
+        case ERROR_NUMERO_MAL_FORMADO: return "Literal numérico mal formado";
+        case ERROR_SANGRIA_INCONSISTENTE: return "La sangría no coincide con ningún nivel anterior";
+        case ERROR_DEMASIADAS_SANGRIAS: return "Demasiados niveles de sangría";
+        case ERROR_CAMPO_FSTRING_SIN_CERRAR: return "El f-string se cierra sin cerrar el campo de sustitución";
+        case ERROR_COMPRIMIDO_INCOMPLETO: return "Los datos comprimidos están incompletos";
+        case ERROR_COMPRIMIDO_DANADO: return "Los datos comprimidos están dañados";
+    }
+
+    return "Error desconocido";
+}
+
+// Imprime los errores del registro seleccionado y lo vacía
+size_t imprimirErrores(FILE *salida){
+
+    registroErrores *registro = registroActual != NULL ? registroActual : &registroPorDefecto;
+    size_t total = registro->numErrores + registro->numDescartados;
+
+    for(size_t i = 0; i < registro->numErrores; i++){
+        errorAnalisis *e = &registro->errores[i];
+
+        fprintf(salida, "ERROR (línea %d, columna %d, byte %zu): %s", e->posicion.linea, e->posicion.columna,
+                e->posicion.desplazamiento, mensajeError(e->codigo));
+
+        if(e->codigo == ERROR_LEXEMA_EXCEDIDO) fprintf(salida, " (%zu)", e->dato);
+        else if(e->codigo == ERROR_CARACTER_NO_RECONOCIDO) fprintf(salida, ": %c", (char) e->dato);
+
+        fprintf(salida, "\n");
+    }
+
+    if(registro->numDescartados > 0){
+        fprintf(salida, "ERROR: %zu errores más no se han guardado\n", registro->numDescartados);
+    }
+
+    vaciarRegistroErrores(registro);
+
+    return total;
+}
+
+//------------------------------------------ FUNCIONES PRIVADAS --------------------------------------------------
+
+// Guarda un error en el registro seleccionado. La posición solo se calcula si el error cabe
+void registrarError(codigoError codigo, int enInicioLexema, size_t dato){
+
+    registroErrores *registro = registroActual != NULL ? registroActual : &registroPorDefecto;
+
+    if(registro->numErrores == MAX_ERRORES){
+        registro->numDescartados++;
+        return;
+    }
+
+    errorAnalisis *e = &registro->errores[registro->numErrores++];
+
+    e->codigo = codigo;
+    e->dato = dato;
+
+    if(enInicioLexema) posicionInicioLexema(&e->posicion);
+    else posicionDelantero(&e->posicion);
 }
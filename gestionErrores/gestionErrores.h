@@ -3,14 +3,54 @@
  * @brief Fichero que contiene las funciones de gestionErrores.c
  * 
  * Este archivo contiene las cabeceras de las funciones de gestionErrores.c
+ *
+ * Los errores del análisis no se imprimen al producirse: se guardan en el registro
+ * de errores seleccionado en el hilo (con su código y su posición en la entrada) y
+ * se imprimen al pedirlo, de forma que el análisis continúa tras un error.
 */
 
 #ifndef GESTIONERRORES_H
 #define GESTIONERRORES_H
 
+#include <stdio.h>
+#include "../sistemaEntrada/sistemaEntrada.h"
+
+// Número máximo de errores que guarda un registro, los siguientes solo se cuentan
+#define MAX_ERRORES 64
+
+// Códigos de los errores del análisis
+typedef enum codigoError {
+    ERROR_LEXEMA_EXCEDIDO = 1,   // El lexema no cabe en el buffer, se trunca
+    ERROR_CARACTER_NO_RECONOCIDO, // Caracteres que no empiezan ningún componente, se descartan
+    ERROR_STRING_SIN_CERRAR,     // El fichero (o la línea, si no es de triples comillas) acaba dentro de un string
+    ERROR_COMENTARIO_SIN_CERRAR, // El fichero acaba dentro de un comentario """ o '''
+    ERROR_MEMORIA,               // No se pudo reservar memoria para un lexema
+    ERROR_NUMERO_MAL_FORMADO,    // Literal numérico que Python no admite (012, 1_, 0x, 1e...)
+    ERROR_SANGRIA_INCONSISTENTE, // La sangría no vuelve a ninguno de los niveles abiertos
+    ERROR_DEMASIADAS_SANGRIAS,   // Se supera MAX_SANGRIAS niveles de sangría
+    ERROR_CAMPO_FSTRING_SIN_CERRAR, // Un f-string se cierra con un campo de sustitución abierto
+    ERROR_COMPRIMIDO_INCOMPLETO, // Los datos comprimidos acaban a mitad de un miembro
+    ERROR_COMPRIMIDO_DANADO      // Los datos comprimidos no son válidos, se analiza lo descomprimido hasta ellos
+} codigoError;
+
+// Error guardado en un registro
+typedef struct error {
+    codigoError codigo;
+    posicionEntrada posicion;
+    size_t dato; // Caracter no reconocido o tamaño máximo del lexema, según el código
+} errorAnalisis;
+
+// Registro acotado de errores
+typedef struct registroErrores {
+    errorAnalisis errores[MAX_ERRORES];
+    size_t numErrores; // Errores guardados
+    size_t numDescartados; // Errores que no cupieron en el registro
+} registroErrores;
+
 
 /**
- * No se encuentra el fichero y se sale del programa
+ * No se encuentra el fichero. Ninguna función de gestión de errores termina el programa,
+ * es el llamador quien decide si debe salir
  * @param nombreFichero Nombre del fichero que no se ha encontrado
  */
 void ficheroNoEncontrado(char *nombreFichero);
@@ -26,10 +66,82 @@ void tamLexemaExcedido();
  */
 void caracterNoReconocido(char c);
 
+/**
+ * El fichero, o la línea si no es de triples comillas, acaba antes de cerrar el string que
+ * empieza en el inicio del lexema
+ */
+void stringSinCerrar();
+
+/**
+ * El fichero acaba antes de cerrar el comentario que empieza en el inicio del lexema
+ */
+void comentarioSinCerrar();
+
+/**
+ * No se pudo reservar memoria durante el análisis
+ */
+void errorMemoria();
+
+/**
+ * El literal numérico que empieza en el inicio del lexema no es válido
+ */
+void numeroMalFormado();
+
+/**
+ * La sangría de la línea que empieza en el delantero no coincide con ningún nivel abierto
+ */
+void sangriaInconsistente();
+
+/**
+ * La línea que empieza en el delantero abre más niveles de sangría de los permitidos
+ */
+void demasiadasSangrias();
+
+/**
+ * Las comillas del delantero cierran un f-string con un campo de sustitución abierto
+ */
+void campoFstringSinCerrar();
+
+/**
+ * La entrada comprimida acaba a mitad de un miembro. Se registra en el fin de la entrada
+ */
+void comprimidoIncompleto();
+
+/**
+ * La entrada comprimida tiene datos dañados. Se registra en el fin de la entrada, que es el
+ * último caracter que se pudo descomprimir
+ */
+void comprimidoDanado();
+
 /**
  * Se ha excedido el tamaño máximo de la tabla de símbolos
  */
 void numParametrosIncorrecto();
 
+/**
+ * Hace que los errores del hilo actual se guarden en el registro indicado
+ * @param registro: registro a usar, NULL para usar el registro propio del hilo
+ */
+void seleccionarRegistroErrores(registroErrores *registro);
+
+/**
+ * Vacía un registro de errores
+ * @param registro: registro a vaciar
+ */
+void vaciarRegistroErrores(registroErrores *registro);
+
+/**
+ * Devuelve el mensaje asociado a un código de error
+ * @param codigo: código del error
+ */
+const char *mensajeError(codigoError codigo);
+
+/**
+ * Imprime los errores del registro seleccionado y lo vacía
+ * @param salida: fichero en el que se imprimen
+ * @return número de errores que se habían producido (incluidos los descartados)
+ */
+size_t imprimirErrores(FILE *salida);
+
 
-#endif
\ No newline at end of file
+#endif
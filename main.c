@@ -2,40 +2,120 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <unistd.h>
 #include "analizadorLexico/analizadorLexico.h"
 #include "./definiciones.h"
 #include "./tablaSimbolos/tablaSimbolos.h"
 #include "./sistemaEntrada/sistemaEntrada.h"
 #include "./analizadorSintactico/analizadorSintactico.h"
 #include "./gestionErrores/gestionErrores.h"
+#include "./perfilado/perfilado.h"
+#include "./archivoZip/archivoZip.h"
 
 int main(int argc,char *argv[]){
 
     FILE *ficheroEntrada;
-    char *nombreFichero = argv[1];
+    char *nombreFichero = NULL;
+    size_t tamBloque = 0; // 0 para usar el tamaño por defecto del sistema de entrada
+    int mostrarPerfil = 0;
+    int gzip = 0; // La entrada está comprimida con gzip
+    int fstrings = 0;
+    long numHilos = sysconf(_SC_NPROCESSORS_ONLN); // Hilos que analizan los miembros de un archivo zip
 
-    if(argc != 2){
+    // Uso: ./miCompilador [-b tam_bloque] [-j hilos] [--profile] [--fstrings] [--gzip] <fichero_entrada | archivo.zip | ->
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--profile") == 0){
+            mostrarPerfil = 1;
+        }
+        // Los f-strings se devuelven separados en sus partes y los componentes de sus campos
+        else if(strcmp(argv[i], "--fstrings") == 0){
+            separarFstrings(NULL, 1);
+            fstrings = 1;
+        }
+        // Entrada comprimida con gzip, necesario al leer de la entrada estándar (un fichero .gz se reconoce solo)
+        else if(strcmp(argv[i], "--gzip") == 0){
+            gzip = 1;
+        }
+        else if(strcmp(argv[i], "-b") == 0 && i + 1 < argc){
+            char *fin;
+            tamBloque = strtoul(argv[++i], &fin, 10);
+
+            if(*fin != '\0' || tamBloque == 0){
+                numParametrosIncorrecto();
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if(strcmp(argv[i], "-j") == 0 && i + 1 < argc){
+            char *fin;
+            numHilos = strtol(argv[++i], &fin, 10);
+
+            if(*fin != '\0' || numHilos <= 0 || numHilos > 1024){
+                numParametrosIncorrecto();
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if(nombreFichero == NULL){
+            nombreFichero = argv[i];
+        }
+        else {
+            numParametrosIncorrecto();
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if(nombreFichero == NULL){
         numParametrosIncorrecto();
+        exit(EXIT_FAILURE);
+    }
+
+    size_t longitudNombre = strlen(nombreFichero);
+
+    // Los archivos zip y wheel se analizan miembro a miembro, sin extraerlos
+    if((longitudNombre > 4 && strcmp(nombreFichero + longitudNombre - 4, ".zip") == 0) ||
+       (longitudNombre > 4 && strcmp(nombreFichero + longitudNombre - 4, ".whl") == 0)){
+        archivoZip archivo;
+
+        if(!abrirArchivoZip(&archivo, nombreFichero)) exit(EXIT_FAILURE);
+
+        int correcto = analizarArchivo(&archivo, numHilos > 0 ? (int) numHilos : 1, tamBloque, fstrings);
+
+        cerrarArchivoZip(&archivo);
+
+        return correcto ? EXIT_SUCCESS : EXIT_FAILURE;
     }
 
-    if( (ficheroEntrada = fopen(nombreFichero, "r")) == NULL){
+    // Con "-" se lee de la entrada estándar y se muestran los componentes según se reconocen
+    if(strcmp(nombreFichero, "-") == 0){
+        ficheroEntrada = stdin;
+        setvbuf(stdout, NULL, _IOLBF, 0);
+    }
+    else if( (ficheroEntrada = fopen(nombreFichero, "r")) == NULL){
         ficheroNoEncontrado(nombreFichero);
+        exit(EXIT_FAILURE);
     }
 
-    inicializarDobleCentinela(ficheroEntrada);
+    if(longitudNombre > 3 && strcmp(nombreFichero + longitudNombre - 3, ".gz") == 0) gzip = 1;
+
+    if(!(gzip ? inicializarDobleCentinelaGzip(ficheroEntrada, tamBloque) : inicializarDobleCentinela(ficheroEntrada, tamBloque))){
+        exit(EXIT_FAILURE);
+    }
 
     hashTable tabla;
 
     inicializarTabla(&tabla);
 
     imprimirTabla(tabla);
-    
+
     iniciarAnalisis(&tabla, ficheroEntrada);
 
     imprimirTabla(tabla);
 
+    // Los contadores van a la salida de errores para no mezclarse con los componentes
+    if(mostrarPerfil) imprimirPerfil(stderr);
+
     destruirTabla(tabla);
-    fclose(ficheroEntrada);
+    finalizarDobleCentinela();
+    if(ficheroEntrada != stdin) fclose(ficheroEntrada);
 
     printf("\n");
-}
\ No newline at end of file
+}